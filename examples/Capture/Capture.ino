@@ -0,0 +1,51 @@
+/**
+ * @file Capture.ino
+ * @brief Record raw receiver pulses for off-target replay.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * This sketch streams every pulse seen by the 433MHz receiver over Serial,
+ * in the binary capture format of PulseCapture.h. Save the serial stream to a
+ * file (e.g. 'cat /dev/ttyUSB0 > capture.obpc' after setting the baud rate)
+ * and feed it through the decoders on a PC with extras/host/replay.cpp.
+ * The receiver must be hooked up to GPIO 2 (or any other interrupt-enabled).
+ *
+ * Nothing else must be printed on Serial, or the capture gets corrupted.
+ *
+ */
+
+#include <PulseCapture.h>
+#include <PulseRing.h>
+
+// Define the pin where the 433Mhz receiver is attached
+// Must be interrupt enabled!
+#define RCVR_PIN 2
+
+PulseRing<word, 64> pulses;
+PulseCaptureWriter capture(Serial);
+
+// add 'ICACHE_RAM_ATTR' if running on ESP
+void mExtInterrupt() {
+  static word last;
+  // determine the pulse length in microseconds, for either polarity
+  word p = micros() - last;
+  last += p;
+  pulses.push(p);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(500);
+
+  capture.begin();
+
+  pinMode(RCVR_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(RCVR_PIN), mExtInterrupt, CHANGE);
+}
+
+void loop() {
+  word p;
+  while (pulses.pop(p)) capture.write(p);
+}
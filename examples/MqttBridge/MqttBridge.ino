@@ -91,38 +91,66 @@ void loop() {
 
 /**
  * A valid data packet has been received.
- * Data can be accessed via library functions (temp, humidity, ...)
+ * Every field has already been parsed into 'reading' (temp, humidity, ...)
  * You can filter by ID, type, etc. and react accordingly.
  */
-void osCallback(Device* device, const byte* data) {
-  const char* _p = device->getOsVersion();
-  const char* _m = device->getRemoteModel(data);
-  byte _i = device->getId(data);
-  byte _c = device->getChannel(data);
-  float _t = device->getTemperature(data);
-  byte _h = device->getHumidity(data);
-  bool _b = device->getBattery(data);
-
-  Serial.println("\n--- Found remote - model " + String(_m) + " ---");
-  Serial.println("Version: \tOS " + String(_p));
-  Serial.print("ID: \t\t" + String(_i) + ", HEX ");
+void osCallback(const Reading& reading) {
+  const char* _m = reading.modelName;
+  byte _i = reading.id;
+  byte _c = reading.channel;
+  char _t[8];
+  formatTenths(reading.temperature, _t, sizeof _t);
+  byte _h = reading.humidity;
+  bool _b = reading.battery;
+
+  // one print per piece: String concatenation would allocate on the heap
+  Serial.print(F("\n--- Found remote - model "));
+  Serial.print(_m);
+  Serial.println(F(" ---"));
+  Serial.print(F("Version: \tOS "));
+  Serial.println(protocolName(reading.protocol));
+  Serial.print(F("ID: \t\t"));
+  Serial.print(_i);
+  Serial.print(F(", HEX "));
   Serial.println(_i, HEX);
-  Serial.println("Channel: \t" + String(_c));
-  Serial.println("Battery level: \t" + (_b ? String("good") : String("low")));
-  Serial.println("Temperature: \t" + String(_t) + "°C");
-  Serial.println("Humidity: \t" + String(_h) + "%");
-
-  char buf[8];
-  sprintf(buf, "%.1f", _t);
-  const char* _temp = buf;
-  mqttClient.publish("topic/temperature", _temp);
-
-  sprintf(buf, "%s", String(_h));
-  const char* _hum = buf;
-  mqttClient.publish("topic/humidity", _hum);
-
-  Serial.print("\nSent over MQTT: T. ");
-  Serial.print(_t);
-  Serial.print("°C - H. %");
-  Serial.println(_h);
+  Serial.print(F("Channel: \t"));
+  Serial.println(_c);
+  Serial.print(F("Battery level: \t"));
+  Serial.println(_b ? F("good") : F("low"));
+  if (reading.hasTemperature) {
+    Serial.print(F("Temperature: \t"));
+    Serial.print(_t);
+    Serial.println(F("°C"));
+  }
+  if (reading.hasHumidity) {
+    Serial.print(F("Humidity: \t"));
+    Serial.print(_h);
+    Serial.println(F("%"));
+  }
+
+  if (reading.hasTemperature) mqttClient.publish("topic/temperature", _t);
+
+  if (reading.hasHumidity) {
+    char _hum[4];
+    snprintf(_hum, sizeof _hum, "%u", _h);
+    mqttClient.publish("topic/humidity", _hum);
+  }
+
+  // every field as one JSON object, e.g. for Home Assistant or Node-RED;
+  // formatReading() returns the size needed, the buffer is checked first
+  char json[160];
+  if (formatReading(reading, READING_JSON, json, sizeof json) < sizeof json)
+    mqttClient.publish("topic/reading", json);
+
+  Serial.print("\nSent over MQTT:");
+  if (reading.hasTemperature) {
+    Serial.print(" T. ");
+    Serial.print(_t);
+    Serial.print("°C");
+  }
+  if (reading.hasHumidity) {
+    Serial.print(" H. %");
+    Serial.print(_h);
+  }
+  Serial.println();
 }
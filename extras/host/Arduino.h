@@ -0,0 +1,121 @@
+/**
+ * Arduino.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file Arduino.h
+ * @brief Minimal Arduino API shim to build the library on a Linux host.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Only what the library uses is provided: Arduino integer types, micros()
+ * and millis() on the host monotonic clock (or a simulated one), no-op
+ * interrupt control and a Print class writing to stdout.
+ *
+ * Revision history:
+ * - Oct. 2026: host shim added to OregonBridge library.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define HEX 16
+#define DEC 10
+
+/* Flash strings are plain strings on the host */
+#define F(s) (s)
+
+/**
+ * Simulated time, for tools driving the interrupt path on a virtual clock
+ * (see latency.cpp): once set with setMicros(), micros() and millis()
+ * follow it instead of the monotonic clock.
+ */
+struct SimulatedClock {
+  bool enabled;
+  unsigned long now;
+};
+
+inline SimulatedClock& simulatedClock(void) {
+  static SimulatedClock clock = {false, 0};
+  return clock;
+}
+
+inline void setMicros(unsigned long t) {
+  simulatedClock().enabled = true;
+  simulatedClock().now = t;
+}
+
+inline unsigned long micros(void) {
+  if (simulatedClock().enabled) return simulatedClock().now;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+inline unsigned long millis(void) {
+  return micros() / 1000;
+}
+
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+
+class Print {
+ public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+
+  size_t print(const char* s) {
+    return write((const uint8_t*)s, strlen(s));
+  }
+
+  size_t print(long value, int base = DEC) {
+    char buf[24];
+    snprintf(buf, sizeof buf, base == HEX ? "%lX" : "%ld", value);
+    return print(buf);
+  }
+
+  size_t println(const char* s = "") {
+    return print(s) + print("\n");
+  }
+
+  size_t println(long value, int base = DEC) {
+    return print(value, base) + print("\n");
+  }
+};
+
+/* Print to a stdio stream */
+class FilePrint : public Print {
+ public:
+  FilePrint(FILE* file) : file(file) {}
+
+  size_t write(uint8_t c) {
+    return fputc(c, file) == EOF ? 0 : 1;
+  }
+
+  size_t write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, file);
+  }
+
+ private:
+  FILE* file;
+};
+
+static FilePrint Serial(stdout);
+
+#endif
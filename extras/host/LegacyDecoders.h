@@ -0,0 +1,283 @@
+/**
+ * LegacyDecoders.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file LegacyDecoders.h
+ * @brief The v1 and v2.1 decoders of OregonBridge 1.0, as a reference for
+ * the benchmarks: virtual decode() and gotBit(), one bit at a time into
+ * data[pos], bit reversal in an 8-step loop.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Copied unchanged from the 1.0 sources (src/DecodeOOK.h,
+ * src/OregonDevice_v1.h, src/OregonDevice_v2.h), in namespace 'legacy'.
+ *
+ * Revision history:
+ * - Oct. 2026: legacy decoders added to OregonBridge library.
+ */
+
+#ifndef LegacyDecoders_h
+#define LegacyDecoders_h
+
+#include "Arduino.h"
+
+namespace legacy {
+
+class DecodeOOK {
+ protected:
+  byte total_bits, bits, flip, state, pos, data[25];
+
+  virtual char decode(word width) = 0;
+
+ public:
+  enum { UNKNOWN,
+         T0,
+         T1,
+         T2,
+         T3,
+         OK,
+         DONE };
+
+  DecodeOOK() { resetDecoder(); }
+
+  bool nextPulse(word width) {
+    if (state != DONE)
+
+      switch (decode(width)) {
+        case -1:
+          resetDecoder();
+          break;
+        case 1:
+          done();
+          break;
+      }
+    return isDone();
+  }
+
+  bool isDone() const { return state == DONE; }
+
+  const byte* getData(byte& count) const {
+    count = pos;
+    return data;
+  }
+
+  void resetDecoder() {
+    total_bits = bits = pos = flip = 0;
+    state = UNKNOWN;
+  }
+
+  // add one bit to the packet data buffer
+  virtual void gotBit(char value) {
+    total_bits++;
+    byte* ptr = data + pos;
+    *ptr = (*ptr >> 1) | (value << 7);
+
+    if (++bits >= 8) {
+      bits = 0;
+      if (++pos >= sizeof data) {
+        resetDecoder();
+        return;
+      }
+    }
+    state = OK;
+  }
+
+  // store a bit using Manchester encoding
+  void manchester(char value) {
+    flip ^= value;  // manchester code, long pulse flips the bit
+    gotBit(flip);
+  }
+
+  // move bits to the front so that all the bits are aligned to the end
+  void alignTail(byte max = 0) {
+    // align bits
+    if (bits != 0) {
+      data[pos] >>= 8 - bits;
+      for (byte i = 0; i < pos; ++i)
+        data[i] = (data[i] >> bits) | (data[i + 1] << (8 - bits));
+      bits = 0;
+    }
+    // optionally shift bytes down if there are too many of 'em
+    if (max > 0 && pos > max) {
+      byte n = pos - max;
+      pos = max;
+      for (byte i = 0; i < pos; ++i)
+        data[i] = data[i + n];
+    }
+  }
+
+  void reverseBits() {
+    for (byte i = 0; i < pos; ++i) {
+      byte b = data[i];
+      for (byte j = 0; j < 8; ++j) {
+        data[i] = (data[i] << 1) | (b & 1);
+        b >>= 1;
+      }
+    }
+  }
+
+  void reverseNibbles() {
+    for (byte i = 0; i < pos; ++i)
+      data[i] = (data[i] << 4) | (data[i] >> 4);
+  }
+
+  void done() {
+    while (bits)
+      gotBit(0);  // padding
+    state = DONE;
+  }
+};
+
+class OregonDecoder_v1 : public DecodeOOK {
+ public:
+  virtual char decode(word width) {
+    if (900 <= width && width <= 7000) {
+      byte w = width >= 2300;
+
+      switch (state) {
+        case UNKNOWN:
+          if (w == 0) {
+            // Short pulse
+            ++flip;
+          } else if (w != 0 && 22 <= flip) {
+            // Long pulse, start bit
+            flip = 0;
+            state = T1;
+          } else {
+            // Reset decoder
+            return -1;
+          }
+          break;
+        case OK:
+          /** Due to Manchester encoding: short pulse maintain the same bit
+           * as the previous, long pulses flip the value (1 to 0 or vice
+           * versa)
+           * */
+          if (w == 0) {
+            // Short pulse
+            state = T0;
+          } else {
+            // Long pulse
+            manchester(1);
+          }
+          break;
+        case T0:
+          if (w == 0) {
+            // Second short pulse
+            manchester(0);
+          } else {
+            // Reset decoder
+            return -1;
+          }
+          break;
+        case T1:
+          // RF-on long pulse (approx 5.7 ms)
+          //if (width < 4000) return -1;
+          if (5550 <= width && width <= 6000)
+            state = T2;
+          else
+            return -1;
+          break;
+        case T2:
+          /* RF-off long period (approx 5 ms)
+          If a '0' is the first bit, no signal transition occurs, but can
+          be detected by measuring the pulse length.
+          ~5.2ms: first bit 1
+          ~6.6ms: first bit 0 */
+          if (4800 <= width && width <= 5400) {
+            flip = 1;
+            state = T0;
+          } else if (6480 <= width && width <= 6880) {
+            gotBit(0);
+          } else
+            return -1;
+          break;
+      }
+    } else {
+      return -1;
+    }
+    // Done decoding if a fixed number of 32 bits have been received
+    if (total_bits >= 32) return 1;
+    return 0;
+  }
+};
+
+class OregonDecoder_v2 : public DecodeOOK {
+ public:
+  // add one bit to the packet data buffer
+  virtual void gotBit(char value) {
+    // Add one bit only if the count is even as v2.1 messages are doubled
+    if (!(total_bits & 0x01)) {
+      data[pos] = (data[pos] >> 1) | (value ? 0x80 : 00);
+    }
+    total_bits++;
+    pos = total_bits >> 4;
+    if (pos >= sizeof data) {
+      resetDecoder();
+      return;
+    }
+    state = OK;
+  }
+
+  virtual char decode(word width) {
+    if (200 <= width && width < 1200) {
+      // Pulse length: w=1 -> 'long' pulse, w=0 -> 'short' pulse
+      byte w = width >= 700;
+
+      switch (state) {
+        case UNKNOWN:
+
+          /* For v2.1 or v3 sensors, the preamble consists of “1” bits, 24 bits (6 nibbles)
+            or v3.0 sensors and 16 bits (4 nibbles) for v2.1 sensors (since a v2.1 sensor bit
+            stream contains an inverted and interleaved copy of the data bits, there is in fact
+            a 32 bit sequence of alternating “0” and “1” bits in the preamble). 
+            Here, if more then 24 '01' (or '10') are detected by detecting a flip. i.e. a long
+            pulse, the preamble is considered finished, and we wait for the sync nibble - which
+            is '1010', or hex 'A'. Long bits are used for the count. */
+
+          if (w != 0) {
+            // Long pulse
+            ++flip;
+          } else if (w == 0 && 24 <= flip) {
+            // Short pulse, start bit
+            flip = 0;
+            state = T0;
+          } else {
+            // Reset decoder
+            return -1;
+          }
+          break;
+        case OK:
+          if (w == 0) {
+            // Short pulse
+            state = T0;
+          } else {
+            // Long pulse
+            manchester(1);
+          }
+          break;
+        case T0:
+          if (w == 0) {
+            // Second short pulse
+            manchester(0);
+          } else {
+            // Reset decoder
+            return -1;
+          }
+          break;
+      }
+    } else if (width >= 2500 && pos >= 8) {
+      /* If at least 8 bits have been received, and a long duration signal
+      ('trailing off sync') is detected, the decoder is done and return successfully. */
+      return 1;
+    } else {
+      return -1;
+    }
+    return 0;
+  }
+};
+
+}  // namespace legacy
+
+#endif
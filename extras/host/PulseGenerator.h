@@ -0,0 +1,422 @@
+/**
+ * PulseGenerator.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file PulseGenerator.h
+ * @brief Host-side synthesis of Oregon Scientific pulse trains, with timing
+ * jitter, clock skew, dropped edges and noise, for load and yield testing.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Frames follow the layouts parsed by OregonDevice_v1, OregonDevice_v2 and
+ * OregonDevice_v3 (nibble positions, checksum position), and pulse trains
+ * the timings accepted by their decoders:
+ *
+ * - v1:   342 Hz Manchester (1465 / 2930 us pulses), 12 bit preamble, sync
+ *         ~4.2 ms off, ~5.7 ms on, then ~5.2 ms (first bit 1) or ~6.6 ms
+ *         (first bit 0) off, 32 bits.
+ * - v2.1: 1024 Hz Manchester (488 / 976 us pulses), every bit followed by its
+ *         inverted copy, 16 bit preamble, sync nibble 'A', payload, then the
+ *         trailing-off sync (a long RF-off period).
+ * - v3:   same timing as v2.1, every bit sent once, 24 bit preamble, sync
+ *         nibble 'A', payload, checksum and a CRC-8 byte (not checked).
+ *
+ * Revision history:
+ * - Oct. 2026: PulseGenerator added to OregonBridge library.
+ */
+
+#ifndef PulseGenerator_h
+#define PulseGenerator_h
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace PulseGenerator {
+
+enum Model { THN132N,
+             THGR228N,
+             GENERIC_V1,
+             THGR810,
+             THN802 };
+
+/**
+ * @brief The values a sensor transmits.
+ */
+struct Sensor {
+  Model model;
+  uint8_t id;
+  uint8_t channel;      // 1, 2 or 3
+  int16_t temperature;  // tenths of degree
+  uint8_t humidity;     // percentage (THGR228N, THGR810)
+  bool battery;         // true: good
+};
+
+/**
+ * @brief Impairments applied to the generated signal.
+ */
+struct Channel {
+  double jitter = 0;        // standard deviation of each edge position [us]
+  double skewPpm = 0;       // each sensor clock is off by up to +-skewPpm
+  double dropEdge = 0;      // probability of losing each edge
+  double burst = 0;         // probability of a noise burst inside a transmission
+  bool idleNoise = false;   // fill the time between transmissions with receiver noise
+  uint32_t noiseMin = 20;   // noise pulse widths [us]
+  uint32_t noiseMax = 600;
+};
+
+/**
+ * @brief Builds a v2.1 frame, as stored by OregonDecoder_v2 (received nibbles
+ * low first, sync nibble 'A' included). Checksum at nibble 16, as expected by
+ * OregonDevice_v2::getChecksumPos().
+ *
+ * @return the frame bytes
+ */
+inline std::vector<uint8_t> frameV2(const Sensor& s) {
+  std::vector<uint8_t> d(10, 0);
+  bool th = s.model == THGR228N;
+  d[0] = th ? 0x1A : 0xEA;
+  d[1] = th ? 0x2D : 0x4C;
+  // channel nibble: one bit per channel (1, 2, 4)
+  d[2] = (1 << (s.channel - 1)) << 4;
+  d[3] = s.id;
+
+  uint16_t t = s.temperature < 0 ? -s.temperature : s.temperature;
+  d[4] = ((t % 10) << 4) | (s.battery ? 0 : 0x4);
+  d[5] = (((t / 100) % 10) << 4) | ((t / 10) % 10);
+  d[6] = s.temperature < 0 ? 0x8 : 0;
+  if (th) {
+    d[6] |= (s.humidity % 10) << 4;
+    d[7] = (s.humidity / 10) % 10;
+  }
+
+  unsigned sum = 0;
+  for (int i = 0; i < 8; i++) sum += (d[i] >> 4) + (d[i] & 0x0f);
+  d[8] = (sum - 0x0a) & 0xff;
+  return d;
+}
+
+/**
+ * @brief Builds a v1 frame, as stored by OregonDecoder_v1.
+ *
+ * @return the frame bytes
+ */
+inline std::vector<uint8_t> frameV1(const Sensor& s) {
+  static const uint8_t channels[] = {0x0, 0x2, 0x4, 0x8};
+  std::vector<uint8_t> d(4, 0);
+  uint16_t t = s.temperature < 0 ? -s.temperature : s.temperature;
+  d[0] = (channels[s.channel & 3] << 4) | (s.id & 0x0f);
+  d[1] = (((t / 10) % 10) << 4) | (t % 10);
+  d[2] = ((t / 100) % 10) | (s.temperature < 0 ? 0x20 : 0) | (s.battery ? 0 : 0x80);
+  d[3] = (d[0] + d[1] + d[2]) & 0xff;
+  return d;
+}
+
+/* true for the models sending Oregon Scientific v3 */
+inline bool isV3(Model m) {
+  return m == THGR810 || m == THN802;
+}
+
+/**
+ * @brief Builds a v3 frame, as stored by OregonDecoder_v3: temperature as in
+ * v2.1, checksum at nibble 16 (THGR810) or 13 (THN802), then a stand-in for
+ * the CRC-8 byte: polynomial 0x07, initial value 0, over nibbles 1 to the
+ * checksum, the rolling id excluded (the real initial value depends on the
+ * model; the decoder does not check this byte). A zero nibble follows, so
+ * that the last bit is complete on the air.
+ *
+ * @return the frame bytes
+ */
+inline std::vector<uint8_t> frameV3(const Sensor& s) {
+  bool th = s.model == THGR810;
+  uint8_t sumPos = th ? 16 : 13;
+  std::vector<uint8_t> n(sumPos + 5, 0);
+  static const uint8_t thgr810[] = {0xa, 0xf, 0x8, 0x2}, thn802[] = {0xa, 0xc, 0x8, 0x4};
+  for (int i = 0; i < 4; i++) n[i] = th ? thgr810[i] : thn802[i];
+  n[4] = 0;
+  n[5] = s.channel;
+  n[6] = s.id & 0x0f;
+  n[7] = s.id >> 4;
+  n[8] = s.battery ? 0 : 0x4;
+
+  uint16_t t = s.temperature < 0 ? -s.temperature : s.temperature;
+  n[9] = t % 10;
+  n[10] = (t / 10) % 10;
+  n[11] = (t / 100) % 10;
+  n[12] = s.temperature < 0 ? 0x8 : 0;
+  if (th) {
+    n[13] = s.humidity % 10;
+    n[14] = (s.humidity / 10) % 10;
+  }
+
+  unsigned sum = 0;
+  uint8_t crc = 0;
+  for (int i = 0; i < sumPos; i++) {
+    sum += n[i];
+    if (i == 0 || i == 6 || i == 7) continue;
+    for (int b = 3; b >= 0; b--) {
+      bool top = (crc >> 7) ^ ((n[i] >> b) & 1);
+      crc = (crc << 1) ^ (top ? 0x07 : 0);
+    }
+  }
+  sum = (sum - 0x0a) & 0xff;
+  n[sumPos] = sum & 0x0f;
+  n[sumPos + 1] = sum >> 4;
+  n[sumPos + 2] = crc & 0x0f;
+  n[sumPos + 3] = crc >> 4;
+
+  std::vector<uint8_t> d((n.size() + 1) / 2, 0);
+  for (size_t i = 0; i < n.size(); i++) d[i / 2] |= n[i] << (i & 1 ? 4 : 0);
+  return d;
+}
+
+/**
+ * @brief A transmission: pulse widths [us] in order, the first one RF-on.
+ */
+typedef std::vector<uint32_t> Pulses;
+
+/* Manchester-encodes 'bits' following 'prev': equal bits give two short pulses, a change one long */
+inline void manchester(Pulses& out, const std::vector<uint8_t>& bits, uint8_t prev, uint32_t half) {
+  for (size_t i = 0; i < bits.size(); i++) {
+    if (bits[i] == prev) {
+      out.push_back(half);
+      out.push_back(half);
+    } else {
+      out.push_back(2 * half);
+    }
+    prev = bits[i];
+  }
+}
+
+/* Bits of a frame, least significant bit of each byte first */
+inline std::vector<uint8_t> frameBits(const std::vector<uint8_t>& frame) {
+  std::vector<uint8_t> bits;
+  for (size_t i = 0; i < frame.size(); i++)
+    for (int b = 0; b < 8; b++) bits.push_back((frame[i] >> b) & 1);
+  return bits;
+}
+
+/**
+ * @brief Nominal pulse train of one transmission, without the final RF-off
+ * period (the gap to the next transmission is the trailing sync).
+ */
+inline Pulses transmission(const Sensor& s) {
+  Pulses out;
+  if (s.model == GENERIC_V1) {
+    const uint32_t half = 1465;
+    std::vector<uint8_t> bits = frameBits(frameV1(s));
+    // preamble: 12 '1' bits, i.e. 23 short pulses starting and ending RF-on
+    for (int i = 0; i < 23; i++) out.push_back(half);
+    out.push_back(4200);
+    out.push_back(5700);
+    if (bits[0]) {
+      // the first half of bit '1' is in the RF-off sync
+      out.push_back(5200);
+      out.push_back(half);
+    } else {
+      out.push_back(6600);
+    }
+    manchester(out, std::vector<uint8_t>(bits.begin() + 1, bits.end()), bits[0], half);
+  } else if (isV3(s.model)) {
+    const uint32_t half = 488;
+    // preamble: 24 '1' bits, i.e. short pulses only
+    std::vector<uint8_t> raw(24, 1);
+    std::vector<uint8_t> data = frameBits(frameV3(s));
+    raw.insert(raw.end(), data.begin(), data.end());
+    out.push_back(half);
+    manchester(out, std::vector<uint8_t>(raw.begin() + 1, raw.end()), raw[0], half);
+  } else {
+    const uint32_t half = 488;
+    std::vector<uint8_t> data = frameBits(frameV2(s));
+    // preamble: 16 '1' bits, sent doubled (bit, inverted bit)
+    std::vector<uint8_t> raw;
+    for (int i = 0; i < 16; i++) {
+      raw.push_back(1);
+      raw.push_back(0);
+    }
+    for (size_t i = 0; i < data.size(); i++) {
+      raw.push_back(data[i]);
+      raw.push_back(!data[i]);
+    }
+    out.push_back(half);
+    manchester(out, std::vector<uint8_t>(raw.begin() + 1, raw.end()), raw[0], half);
+  }
+  return out;
+}
+
+/**
+ * @brief Produces a whole capture: several sensors, each transmitting at its
+ * own period, merged on the air (overlapping transmissions collide), with
+ * the impairments of 'channel'.
+ */
+class Generator {
+ public:
+  Generator(const Channel& channel, uint32_t seed) : channel(channel), rng(seed) {}
+
+  /**
+   * @brief Adds a sensor transmitting every 'period' seconds ('repeats'
+   * copies of each message, 'gap' us apart).
+   */
+  void addSensor(const Sensor& s, double period, int repeats, uint32_t gap) {
+    Source src;
+    src.sensor = s;
+    src.period = period * 1e6;
+    src.repeats = repeats;
+    src.gap = gap;
+    std::uniform_real_distribution<double> skew(-channel.skewPpm, channel.skewPpm);
+    src.clock = 1 + skew(rng) * 1e-6;
+    src.nominal = transmission(s);
+    sources.push_back(src);
+  }
+
+  /**
+   * @brief Changes the batteries of every sensor at 'at' seconds: silent for
+   * 'pause' seconds, then transmitting with a new random id.
+   */
+  void changeBatteries(double at, double pause) {
+    for (size_t k = 0; k < sources.size(); k++) {
+      Source& src = sources[k];
+      Sensor renewed = src.sensor;
+      // v1 ids are 4 bits wide
+      uint8_t mask = src.sensor.model == GENERIC_V1 ? 0x0f : 0xff;
+      std::uniform_int_distribution<int> id(1, mask);
+      renewed.id = (src.sensor.id ^ id(rng)) & mask;
+      src.renewed = transmission(renewed);
+      src.changeAt = at * 1e6;
+      src.resumeAt = (at + pause) * 1e6;
+    }
+  }
+
+  /**
+   * @brief Generates 'seconds' of received signal.
+   *
+   * @param out receives the pulse widths [us]
+   * @return the number of messages transmitted (repeats excluded)
+   */
+  uint32_t generate(double seconds, Pulses& out) {
+    const double end = seconds * 1e6;
+    std::vector<Interval> on, spans;
+    uint32_t messages = 0;
+
+    std::uniform_real_distribution<double> phase(0, 1);
+    for (size_t k = 0; k < sources.size(); k++) {
+      Source& src = sources[k];
+      for (double t = phase(rng) * src.period; t < end; t += src.period * src.clock) {
+        // batteries out, then a new id
+        if (src.changeAt <= t && t < src.resumeAt) continue;
+        const Pulses& nominal = t < src.changeAt ? src.nominal : src.renewed;
+        messages++;
+        double start = t;
+        for (int r = 0; r < src.repeats; r++) {
+          double stop = addTransmission(src, nominal, start, on);
+          spans.push_back({start, stop});
+          start = stop + src.gap;
+        }
+      }
+    }
+
+    auto byStart = [](const Interval& a, const Interval& b) { return a.start < b.start; };
+    std::sort(on.begin(), on.end(), byStart);
+    std::sort(spans.begin(), spans.end(), byStart);
+
+    // merge what overlaps on the air
+    std::vector<Interval> air;
+    for (size_t i = 0; i < on.size(); i++) {
+      if (!air.empty() && on[i].start <= air.back().end)
+        air.back().end = std::max(air.back().end, on[i].end);
+      else
+        air.push_back(on[i]);
+    }
+
+    // fill the silence between transmissions (not the gaps inside one) with noise
+    if (channel.idleNoise) {
+      double last = 0;
+      for (size_t i = 0; i < spans.size(); i++) {
+        addNoise(last, spans[i].start - 1000, air);
+        last = std::max(last, spans[i].end + 3000);
+      }
+      addNoise(last, end, air);
+      std::sort(air.begin(), air.end(), byStart);
+    }
+
+    // edges to pulse widths, losing edges if requested
+    std::bernoulli_distribution drop(channel.dropEdge);
+    double prev = 0;
+    for (size_t i = 0; i < air.size(); i++) {
+      double edges[2] = {air[i].start, air[i].end};
+      for (int e = 0; e < 2; e++) {
+        if (channel.dropEdge > 0 && drop(rng)) continue;
+        double width = edges[e] - prev;
+        prev = edges[e];
+        out.push_back(width < 1 ? 1 : (uint32_t)(width + 0.5));
+      }
+    }
+    return messages;
+  }
+
+ private:
+  struct Source {
+    Sensor sensor;
+    double period;
+    int repeats;
+    uint32_t gap;
+    double clock;
+    Pulses nominal;
+    // after a battery change (see changeBatteries())
+    Pulses renewed;
+    double changeAt = 1e300, resumeAt = 1e300;
+  };
+
+  struct Interval {
+    double start, end;
+  };
+
+  /* Adds the RF-on intervals of one transmission starting at 't', returns its end */
+  double addTransmission(const Source& src, const Pulses& nominal, double t, std::vector<Interval>& on) {
+    std::normal_distribution<double> jitter(0, channel.jitter > 0 ? channel.jitter : 1);
+    std::bernoulli_distribution burst(channel.burst);
+    std::uniform_int_distribution<size_t> where(0, nominal.size() - 1);
+    size_t burstAt = channel.burst > 0 && burst(rng) ? where(rng) : nominal.size();
+
+    bool rfOn = true;
+    for (size_t i = 0; i < nominal.size(); i++) {
+      double width = nominal[i] * src.clock;
+      if (channel.jitter > 0) width = std::max(1.0, width + jitter(rng));
+      if (rfOn) on.push_back({t, t + width});
+      t += width;
+      rfOn = !rfOn;
+
+      if (i == burstAt) {
+        std::uniform_int_distribution<int> count(2, 12);
+        std::uniform_int_distribution<uint32_t> w(channel.noiseMin, channel.noiseMax);
+        for (int n = count(rng); n > 0; n--) {
+          double a = t + w(rng), b = a + w(rng);
+          on.push_back({a, b});
+        }
+      }
+    }
+    return t;
+  }
+
+  /* Adds random RF-on noise pulses in [from, to) */
+  void addNoise(double from, double to, std::vector<Interval>& air) {
+    std::uniform_int_distribution<uint32_t> w(channel.noiseMin, channel.noiseMax);
+    for (double t = from + w(rng); t < to;) {
+      double width = w(rng);
+      if (t + width >= to) break;
+      air.push_back({t, t + width});
+      t += width + w(rng);
+    }
+  }
+
+  Channel channel;
+  std::mt19937 rng;
+  std::vector<Source> sources;
+};
+
+}  // namespace PulseGenerator
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * TableDecoder.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file TableDecoder.h
+ * @brief A table-driven v2.1 decoder, as a reference for the benchmarks:
+ * pulse widths classed into 2-bit symbols, Manchester decoded two pulses
+ * (one symbol nibble) per table lookup.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026 - MIT Licence
+ *
+ * The framing (preamble, doubled bits, running checksum, trailing sync) is
+ * that of OregonDecoder_v2 without the OS_* options, and the packets are the
+ * same bit for bit: bench.cpp compares them. The table core measured slower
+ * than the branches of DecodeOOK::manchester() on the host, so the library
+ * keeps the branches (see the README).
+ *
+ * Revision history:
+ * - Oct. 2026: table decoder added to OregonBridge library.
+ */
+
+#ifndef TableDecoder_h
+#define TableDecoder_h
+
+#include "OregonDevice_v2.h"
+
+class TableDecoder_v2 final : public DecodeOOK<TableDecoder_v2> {
+  // checksum position of the packet being received, once the model is known
+  byte sumPos;
+  // first data pulse of a nibble, waiting for the second one (0 if none)
+  word held = 0;
+
+  /**
+   * @brief Manchester decoding of a symbol nibble, two data pulses (0 short,
+   * 1 long, first pulse in bit 1), from the state (bit 1: T0, i.e. one short
+   * pulse pending, bit 0: flip). Each entry holds:
+   * - bits 0-1: the decoded bits, the first one in bit 0
+   * - bits 2-3: the bit count, 0 to 2
+   * - bit 4: the next flip, bit 5: the next state is T0
+   * - bit 6: the first bit comes from the first pulse
+   * - bit 7: error, at the first pulse if bit 6 is set, else at the second
+   */
+  static byte transition(byte state, byte nibble) {
+    static const byte table[16] = {
+        // OK, flip 0: short-short, short-long, long-short, long-long
+        0x04, 0x80, 0x75, 0x49,
+        // OK, flip 1
+        0x15, 0x80, 0x64, 0x5a,
+        // T0, flip 0
+        0x64, 0x5a, 0xc0, 0xc0,
+        // T0, flip 1
+        0x75, 0x49, 0xc0, 0xc0};
+    return table[(state << 2) | nibble];
+  }
+
+  // one data pulse alone, as OregonDecoder_v2::decode()
+  char pulse(byte w) {
+    if (state == OK) {
+      if (w == 0)
+        state = T0;
+      else
+        manchester(1);
+    } else if (w == 0) {
+      manchester(0);
+    } else {
+      return -1;
+    }
+    return 0;
+  }
+
+ public:
+  // add one bit to the packet data buffer: v2.1 bits are doubled
+  void gotBit(char value) {
+    byte even = !(total_bits & 0x01);
+    shift = (shift >> even) | (value && even ? 0x80 : 00);
+    if (!(++total_bits & 0x0f)) {
+      data[pos] = shift;
+      bool keep = gotByte(pos);
+      pos = total_bits >> 4;
+      if (!keep || pos >= sizeof data) {
+        resetDecoder();
+        return;
+      }
+    }
+    state = OK;
+  }
+
+  // running 'sum of nibbles' checksum, as OregonDecoder_v2::gotByte()
+  bool gotByte(byte i) {
+    byte b = data[i];
+    if (i < 2) {
+      sum += (b >> 4) + (b & 0x0f);
+      if (i == 1) sumPos = OregonDecoder_v2::checksumPos(OregonDecoder_v2::modelOf(data));
+      return i == 0 || sumPos;
+    }
+    byte last = sumPos >> 1;
+    if (i < last) {
+      sum += (b >> 4) + (b & 0x0f);
+    } else if (i == last) {
+      if (sumPos & 1)
+        sum += b >> 4;
+      else
+        checksumOk = (byte)(sum - 0x0a) == b;
+    } else if (i == last + 1 && (sumPos & 1)) {
+      checksumOk = (byte)(sum - 0x0a) == ((b >> 4) | ((data[last] & 0x0f) << 4));
+    }
+    return true;
+  }
+
+  // merge the data bits received so far into the last, incomplete byte
+  void flushTail() {
+    byte n = ((total_bits & 0x0f) + 1) >> 1;
+    if (n) data[pos] = (data[pos] >> n) | (shift & (0xff << (8 - n)));
+  }
+
+  char decode(word width) {
+    if (200 <= width && width < 1200) {
+      byte w = width >= 700;
+      if (state == UNKNOWN) {
+        held = 0;
+        switch (preamble(w, 1, 24)) {
+          case -1:
+            return -1;
+          case 1:
+            // short pulse, start bit
+            flip = 0;
+            state = T0;
+        }
+        return 0;
+      }
+      if (!held) {
+        held = width;
+        return 0;
+      }
+
+      byte t = transition(((state == T0) << 1) | flip, ((held >= 700) << 1) | w);
+      held = 0;
+      if (t & 0x80) {
+        if (!(t & 0x40)) return -1;
+        // the first pulse failed: the second one starts over
+        resetDecoder();
+        return decode(width);
+      }
+      flip = (t >> 4) & 1;
+      byte count = (t >> 2) & 3;
+      if (count) {
+        // gotBit() may drop the packet: a pulse not decoded yet starts over
+        gotBit(t & 1);
+        if (state == UNKNOWN) return t & 0x40 ? decode(width) : 0;
+        if (count == 2) {
+          gotBit((t >> 1) & 1);
+          if (state == UNKNOWN) return 0;
+        }
+      }
+      state = t & 0x20 ? T0 : OK;
+      return 0;
+    }
+
+    // any other pulse ends the nibble: the held pulse is decoded alone first
+    if (held) {
+      word first = held;
+      held = 0;
+      if (pulse(first >= 700) < 0) return -1;
+      if (state == UNKNOWN) return decode(width);
+    }
+    if (width >= 2500 && pos >= 8) return 1;
+    return -1;
+  }
+};
+
+#endif
@@ -0,0 +1,394 @@
+/**
+ * bench.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file bench.cpp
+ * @brief Per-pulse cost of the bridge as protocols are added: the same
+ * synthetic capture decoded with 2 to 10 protocols.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root (add -DOS_PREAMBLE_FRONTEND=0 to compare
+ * with every pulse fed to every decoder):
+ *
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/bench.cpp \
+ *        src/OregonBridge.cpp -o bench
+ *
+ * Usage:
+ *
+ *    bench [-t seconds] [-n runs]
+ *
+ *    -t seconds length of the synthetic capture (default 600)
+ *    -n runs    timed runs per protocol count, the best is kept (default 5)
+ *
+ * The first three protocols are Oregon Scientific v1, v2.1 and v3; the
+ * others are Manchester protocols with the v3 framing at other bit rates,
+ * standing for further 433 MHz protocols. The capture holds v1, v2.1 and
+ * v3 sensors and receiver noise between transmissions.
+ *
+ * Then the decoders alone, without the bridge: the v1 and v2.1 decoders of
+ * version 1.0 (LegacyDecoders.h, virtual decode() and gotBit()) against
+ * the current ones (CRTP), both fed every pulse, then fed one clean
+ * transmission over and over (ns and, on x86, TSC cycles per packet). Then
+ * the v2.1 decoder against the table-driven one (TableDecoder.h), which
+ * decodes two pulses per table lookup: pulses per second, on the capture and
+ * on one clean transmission, and whether their packets are the same. Last,
+ * the temperature of a frame as text, with float math and printf (as in
+ * 1.0) or in integer tenths with formatTenths().
+ *
+ * Revision history:
+ * - Oct. 2026: bench tool added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Arduino.h"
+#include "LegacyDecoders.h"
+#include "OregonBridge.h"
+#include "PulseGenerator.h"
+#include "TableDecoder.h"
+
+using namespace PulseGenerator;
+
+/**
+ * @brief Manchester decoder with a half bit of 'Half' us: preamble of at
+ * least 32 short pulses, then 64 data bits.
+ */
+template <word Half>
+class ManchesterDecoder final : public DecodeOOK<ManchesterDecoder<Half>> {
+ public:
+  static const byte widthRangeCount = 1;
+  static WidthRange widthRange(byte /*i*/) {
+    return {Half / 2, Half * 5 / 2};
+  }
+
+  static const byte preambleMin = 32;
+  static WidthRange preambleRange() {
+    return {Half / 2, Half * 3 / 2 - 1};
+  }
+
+  char decode(word width) {
+    if (width < Half / 2 || width > Half * 5 / 2) return -1;
+    byte w = width >= Half * 3 / 2;
+    switch (this->state) {
+      case DecodeOOKBase::UNKNOWN:
+        switch (this->preamble(w, 0, preambleMin)) {
+          case -1:
+            return -1;
+          case 1:
+            this->flip = 1;
+            this->manchester(1);
+        }
+        break;
+      case DecodeOOKBase::OK:
+        if (w == 0)
+          this->state = DecodeOOKBase::T0;
+        else
+          this->manchester(1);
+        break;
+      case DecodeOOKBase::T0:
+        if (w != 0) return -1;
+        this->manchester(0);
+        break;
+    }
+    return this->total_bits >= 64;
+  }
+};
+
+template <word Half>
+class ManchesterDevice : public Device {
+ public:
+  typedef ManchesterDecoder<Half> Decoder;
+
+  ManchesterDevice() {
+    this->dDecoder = &ookDecoder;
+  }
+
+  virtual bool nextPulse(word width) {
+    return ookDecoder.nextPulse(width);
+  }
+
+  Decoder& getDecoder() {
+    return ookDecoder;
+  }
+
+ private:
+  Decoder ookDecoder;
+};
+
+typedef ManchesterDevice<160> P4;
+typedef ManchesterDevice<300> P5;
+typedef ManchesterDevice<620> P6;
+typedef ManchesterDevice<1200> P7;
+typedef ManchesterDevice<1800> P8;
+typedef ManchesterDevice<2600> P9;
+typedef ManchesterDevice<3400> P10;
+
+template <class Bridge>
+static void run(int protocols, const std::vector<word>& pulses, int runs) {
+  double best = 0;
+  OregonStats stats = {};
+  for (int r = 0; r < runs; r++) {
+    Bridge* bridge = new Bridge;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pulses.size(); i++) bridge->feedPulse(pulses[i]);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best) best = seconds;
+    stats = bridge->getStats();
+    delete bridge;
+  }
+  printf("%2d protocols: %6.2f ns/pulse, %5.3f decoder calls/pulse, %lu packets\n", protocols,
+         best * 1e9 / pulses.size(), (double)stats.decoderCalls / pulses.size(), (unsigned long)stats.packets);
+}
+
+/**
+ * @brief The decoder path alone, as the 1.0 bridge ran it: the v1 and v2.1
+ * decoders get every pulse. 'legacy' goes through the 1.0 decoders and their
+ * virtual decode()/gotBit(), reached through base pointers as the 1.0 bridge
+ * did; the current decoders are bound at compile time (CRTP).
+ */
+static void decoderPath(const std::vector<word>& pulses, int runs) {
+  double best[2] = {0, 0};
+  unsigned long packets[2] = {0, 0};
+  for (int r = 0; r < runs; r++) {
+    legacy::OregonDecoder_v1 l1;
+    legacy::OregonDecoder_v2 l2;
+    legacy::DecodeOOK* decoders[2] = {&l1, &l2};
+    // hide the dynamic types, as the heap pointers of 1.0 did
+    asm volatile("" : : "r"(decoders) : "memory");
+    packets[0] = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pulses.size(); i++)
+      for (int k = 0; k < 2; k++)
+        if (decoders[k]->nextPulse(pulses[i])) {
+          packets[0]++;
+          decoders[k]->resetDecoder();
+        }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best[0]) best[0] = seconds;
+
+    OregonDecoder_v1 d1;
+    OregonDecoder_v2 d2;
+    packets[1] = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pulses.size(); i++) {
+      if (d1.nextPulse(pulses[i])) {
+        packets[1]++;
+        d1.resetDecoder();
+      }
+      if (d2.nextPulse(pulses[i])) {
+        packets[1]++;
+        d2.resetDecoder();
+      }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best[1]) best[1] = seconds;
+  }
+  printf("decoder path, v1 + v2.1, every pulse to both:\n");
+  printf("  1.0 (virtual): %6.2f ns/pulse, %lu packets\n", best[0] * 1e9 / pulses.size(), packets[0]);
+  printf("  CRTP:          %6.2f ns/pulse, %lu packets\n", best[1] * 1e9 / pulses.size(), packets[1]);
+}
+
+/* Feeds every pulse to 'decoder': best seconds of 'runs', and the packets of the first run */
+template <class Decoder>
+static double timeDecoder(const std::vector<word>& pulses, int runs, std::vector<std::vector<byte>>& packets) {
+  double best = 0;
+  for (int r = 0; r < runs; r++) {
+    Decoder decoder;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pulses.size(); i++)
+      if (decoder.nextPulse(pulses[i])) {
+        if (r == 0) {
+          byte count;
+          const byte* data = decoder.getData(count);
+          packets.push_back(std::vector<byte>(data, data + count));
+          packets.back().push_back(decoder.isChecksumValid());
+        }
+        decoder.resetDecoder();
+      }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best) best = seconds;
+  }
+  return best;
+}
+
+/**
+ * @brief The v2.1 decoder (branches, one pulse per step) against the table
+ * decoder (one symbol nibble per lookup), on 'pulses' and on one clean
+ * v2.1 transmission repeated: both must deliver the same packets.
+ */
+static void tablePath(const std::vector<word>& pulses, int runs) {
+  Pulses raw = transmission({THGR228N, 0x5b, 1, 215, 74, true});
+  std::vector<word> clean;
+  for (int i = 0; i < 10000; i++) {
+    clean.insert(clean.end(), raw.begin(), raw.end());
+    clean.push_back(10000);
+  }
+  const std::vector<word>* inputs[2] = {&pulses, &clean};
+  printf("v2.1 decoder, every pulse:\n");
+  for (int k = 0; k < 2; k++) {
+    std::vector<std::vector<byte>> packets[2];
+    double best[2] = {timeDecoder<OregonDecoder_v2>(*inputs[k], runs, packets[0]),
+                      timeDecoder<TableDecoder_v2>(*inputs[k], runs, packets[1])};
+    for (int v = 0; v < 2; v++)
+      printf("  %s %-9s %6.2f ns/pulse, %6.1f Mpulses/s, %lu packets\n", k ? "transmission:" : "capture:     ",
+             v ? "table:" : "branches:", best[v] * 1e9 / inputs[k]->size(), inputs[k]->size() / best[v] / 1e6,
+             (unsigned long)packets[v].size());
+    printf("  %s packets %s\n", k ? "transmission:" : "capture:     ",
+           packets[0] == packets[1] ? "identical" : "DIFFERENT");
+  }
+}
+
+static unsigned long long cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/* Feeds 'pulses' (one transmission) to 'decoder' n times: best seconds and TSC cycles of 'runs' */
+template <class Decoder>
+static void timePacket(Decoder& decoder, const std::vector<word>& pulses, long n, int runs, double& best,
+                       unsigned long long& bestCycles, unsigned long& packets) {
+  for (int r = 0; r < runs; r++) {
+    packets = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long c0 = cycles();
+    for (long i = 0; i < n; i++) {
+      for (size_t j = 0; j < pulses.size(); j++)
+        if (decoder.nextPulse(pulses[j])) {
+          packets++;
+          decoder.resetDecoder();
+        }
+    }
+    unsigned long long c = cycles() - c0;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best) best = seconds;
+    if (r == 0 || c < bestCycles) bestCycles = c;
+  }
+}
+
+/**
+ * @brief One clean v1 or v2.1 transmission (preamble, data and the trailing
+ * RF-off period) decoded over and over, by the 1.0 decoders (through a base
+ * pointer) and by the current ones.
+ */
+static void packetPath(int runs) {
+  const long n = 100000;
+  const Sensor sensors[2] = {{GENERIC_V1, 3, 3, 123, 0, true}, {THGR228N, 0x5b, 1, 215, 74, true}};
+  printf("one transmission decoded %ld times:\n", n);
+  for (int k = 0; k < 2; k++) {
+    Pulses raw = transmission(sensors[k]);
+    std::vector<word> pulses(raw.begin(), raw.end());
+    pulses.push_back(10000);
+
+    double best[2] = {0, 0};
+    unsigned long long c[2] = {0, 0};
+    unsigned long packets[2] = {0, 0};
+    legacy::OregonDecoder_v1 l1;
+    legacy::OregonDecoder_v2 l2;
+    legacy::DecodeOOK* legacyDecoder = k ? (legacy::DecodeOOK*)&l2 : &l1;
+    asm volatile("" : "+r"(legacyDecoder) : : "memory");
+    timePacket(*legacyDecoder, pulses, n, runs, best[0], c[0], packets[0]);
+    if (k == 0) {
+      OregonDecoder_v1 d1;
+      timePacket(d1, pulses, n, runs, best[1], c[1], packets[1]);
+    } else {
+      OregonDecoder_v2 d2;
+      timePacket(d2, pulses, n, runs, best[1], c[1], packets[1]);
+    }
+    for (int v = 0; v < 2; v++)
+      printf("  %s %-8s %7.1f ns/packet, %6.0f cycles/packet, %lu packets\n", k ? "v2.1" : "v1  ",
+             v ? "CRTP:" : "1.0:", best[v] * 1e9 / n, (double)c[v] / n, packets[v]);
+  }
+}
+
+/**
+ * @brief Temperature of a v2.1 frame as text, through the float accessor and
+ * printf("%.1f") (the path of 1.0, still there without OS_NO_FLOAT) or
+ * through the integer accessor and formatTenths().
+ */
+static void temperaturePath(int runs) {
+  const long n = 1000000;
+  std::vector<uint8_t> frames[2] = {frameV2({THGR228N, 0x5b, 1, 215, 74, true}),
+                                    frameV2({THN132N, 0x11, 2, -84, 0, true})};
+  OregonDevice_v2 device;
+  char buf[8];
+  double best[2] = {0, 0};
+  size_t chars[2] = {0, 0};
+  for (int r = 0; r < runs; r++) {
+    for (int k = 0; k < 2; k++) {
+      chars[k] = 0;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (long i = 0; i < n; i++) {
+        const byte* data = frames[i & 1].data();
+#ifndef OS_NO_FLOAT
+        if (k == 0) {
+          chars[k] += snprintf(buf, sizeof buf, "%.1f", device.getTemperature(data));
+          continue;
+        }
+#endif
+        chars[k] += formatTenths(device.getTemperatureTenths(data), buf, sizeof buf);
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (r == 0 || seconds < best[k]) best[k] = seconds;
+    }
+  }
+  printf("temperature as text, v2.1 frames:\n");
+#ifndef OS_NO_FLOAT
+  printf("  float, printf:          %6.2f ns/reading\n", best[0] * 1e9 / n);
+#endif
+  printf("  tenths, formatTenths(): %6.2f ns/reading\n", best[1] * 1e9 / n);
+}
+
+int main(int argc, char** argv) {
+  double seconds = 600;
+  int runs = 5;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "-t"))
+      seconds = atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "-n"))
+      runs = atoi(argv[i + 1]);
+  }
+  if (seconds <= 0 || runs < 1) {
+    fprintf(stderr, "usage: %s [-t seconds] [-n runs]\n", argv[0]);
+    return 2;
+  }
+
+  Channel channel;
+  channel.idleNoise = true;
+  Generator generator(channel, 1);
+  generator.addSensor({THGR228N, 0x5b, 1, 215, 74, true}, 39, 2, 10000);
+  generator.addSensor({THN132N, 0x11, 2, -84, 0, true}, 41, 2, 10000);
+  generator.addSensor({GENERIC_V1, 3, 3, 123, 0, true}, 43, 1, 0);
+  generator.addSensor({THGR810, 0xc4, 1, -37, 55, true}, 53, 1, 0);
+  generator.addSensor({THN802, 0x2e, 2, 189, 0, true}, 47, 1, 0);
+
+  Pulses raw;
+  generator.generate(seconds, raw);
+  std::vector<word> pulses(raw.size());
+  for (size_t i = 0; i < raw.size(); i++) pulses[i] = raw[i] > 0xffff ? 0xffff : raw[i];
+
+  printf("%lu pulses, preamble front-end %s\n", (unsigned long)pulses.size(), OS_PREAMBLE_FRONTEND ? "on" : "off");
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2>>(2, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3>>(3, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4>>(4, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5>>(5, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5, P6>>(6, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5, P6, P7>>(7, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5, P6, P7, P8>>(8, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5, P6, P7, P8, P9>>(9, pulses, runs);
+  run<OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3, P4, P5, P6, P7, P8, P9, P10>>(10, pulses, runs);
+  decoderPath(pulses, runs);
+  packetPath(runs);
+  tablePath(pulses, runs);
+  temperaturePath(runs);
+  return 0;
+}
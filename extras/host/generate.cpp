@@ -0,0 +1,147 @@
+/**
+ * generate.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file generate.cpp
+ * @brief Writes a synthetic pulse capture (PulseCapture.h) of one or more
+ * Oregon Scientific sensors, for replay.cpp.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root:
+ *
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/generate.cpp -o generate
+ *
+ * Usage:
+ *
+ *    generate [options] -s sensor [-s sensor...] capture.obpc
+ *
+ *    -s model,id,channel,temp[,hum[,low]]
+ *               a sensor: model THN132N, THGR228N, THGR810, THN802 or V1,
+ *               temperature in degrees, humidity in %, 'low' for a low
+ *               battery flag
+ *    -t seconds length of the capture (default 600)
+ *    -j us      edge jitter, standard deviation (default 0)
+ *    -k ppm     sensor clock skew, up to +-ppm (default 0)
+ *    -d prob    probability of dropping each edge (default 0)
+ *    -b prob    probability of a noise burst per transmission (default 0)
+ *    -n         fill the silence with receiver noise
+ *    -c seconds change the batteries at this time: every sensor is silent
+ *               for 60 s, then transmits with a new random id
+ *    -r seed    random seed (default 1)
+ *
+ * Sensors transmit every 39, 41 or 43 s (channel 1, 2, 3); v2.1 sensors
+ * send each message twice, v1 and v3 sensors once.
+ *
+ * Revision history:
+ * - Oct. 2026: generator added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "PulseCapture.h"
+#include "PulseGenerator.h"
+
+using namespace PulseGenerator;
+
+static bool parseSensor(char* arg, Sensor& s) {
+  char* model = strtok(arg, ",");
+  char* id = strtok(NULL, ",");
+  char* channel = strtok(NULL, ",");
+  char* temp = strtok(NULL, ",");
+  char* hum = strtok(NULL, ",");
+  char* low = strtok(NULL, ",");
+  if (!model || !id || !channel || !temp) return false;
+
+  if (!strcasecmp(model, "THN132N"))
+    s.model = THN132N;
+  else if (!strcasecmp(model, "THGR228N"))
+    s.model = THGR228N;
+  else if (!strcasecmp(model, "THGR810"))
+    s.model = THGR810;
+  else if (!strcasecmp(model, "THN802"))
+    s.model = THN802;
+  else if (!strcasecmp(model, "V1"))
+    s.model = GENERIC_V1;
+  else
+    return false;
+
+  s.id = strtoul(id, NULL, 0);
+  s.channel = atoi(channel);
+  if (s.channel < 1 || s.channel > 3) return false;
+  double t = atof(temp);
+  s.temperature = (int16_t)(t < 0 ? t * 10 - 0.5 : t * 10 + 0.5);
+  s.humidity = hum ? atoi(hum) : 0;
+  s.battery = !(low && !strcasecmp(low, "low"));
+  return true;
+}
+
+int main(int argc, char** argv) {
+  Channel channel;
+  double seconds = 600;
+  double change = -1;
+  uint32_t seed = 1;
+  const char* path = NULL;
+  Sensor sensors[16];
+  int count = 0;
+
+  for (int i = 1; i < argc; i++) {
+    bool more = i + 1 < argc;
+    if (!strcmp(argv[i], "-s") && more && count < 16) {
+      if (!parseSensor(argv[++i], sensors[count++])) {
+        fprintf(stderr, "invalid sensor: %s\n", argv[i]);
+        return 2;
+      }
+    } else if (!strcmp(argv[i], "-t") && more)
+      seconds = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-j") && more)
+      channel.jitter = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-k") && more)
+      channel.skewPpm = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-d") && more)
+      channel.dropEdge = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-b") && more)
+      channel.burst = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-n"))
+      channel.idleNoise = true;
+    else if (!strcmp(argv[i], "-c") && more)
+      change = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-r") && more)
+      seed = strtoul(argv[++i], NULL, 0);
+    else
+      path = argv[i];
+  }
+  if (!path || !count) {
+    fprintf(stderr, "usage: %s [-t seconds] [-j us] [-k ppm] [-d prob] [-b prob] [-n] [-c seconds] [-r seed]\n", argv[0]);
+    fprintf(stderr, "       -s model,id,channel,temp[,hum[,low]] [-s ...] capture.obpc\n");
+    return 2;
+  }
+
+  Generator generator(channel, seed);
+  for (int i = 0; i < count; i++) {
+    static const double periods[] = {39, 41, 43};
+    bool v2 = sensors[i].model == THN132N || sensors[i].model == THGR228N;
+    generator.addSensor(sensors[i], periods[sensors[i].channel - 1], v2 ? 2 : 1, 10000);
+  }
+  if (change >= 0) generator.changeBatteries(change, 60);
+
+  Pulses pulses;
+  uint32_t messages = generator.generate(seconds, pulses);
+
+  FILE* f = fopen(path, "wb");
+  if (!f) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return 1;
+  }
+  FilePrint out(f);
+  PulseCaptureWriter capture(out);
+  capture.begin();
+  for (size_t i = 0; i < pulses.size(); i++) capture.write(pulses[i]);
+  fclose(f);
+
+  printf("messages: %lu\n", (unsigned long)messages);
+  printf("pulses:   %lu\n", (unsigned long)pulses.size());
+  return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * latency.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file latency.cpp
+ * @brief Drives the interrupt path (externalInterrupt(), the pulse queue,
+ * loop()) on a simulated clock and reports the pulses dropped by the queue
+ * against the time the sketch spends between two calls to loop().
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root (add -DOS_PULSE_BUFFER_SIZE=128 or
+ * -DOS_TIMESTAMP_ISR to compare queue sizes and interrupt modes):
+ *
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/latency.cpp \
+ *        src/OregonBridge.cpp -o latency
+ *
+ * Usage:
+ *
+ *    latency [-t seconds] [capture.obpc]
+ *
+ *    -t seconds length of the synthetic capture (default 600), used
+ *               when no capture is given
+ *
+ * Every edge of the capture raises the interrupt at its own time; loop() is
+ * called every 'loop delay' of simulated time, standing for the rest of the
+ * sketch (Wi-Fi, MQTT, sensors...), and drains the queue at once. Decoding
+ * itself takes no simulated time. The synthetic capture holds v1, v2.1 and
+ * v3 sensors with receiver noise between transmissions, as a real receiver
+ * outputs.
+ *
+ * Last, the interrupt and loop() are timed on the host clock, per edge and
+ * per pulse, loop() being called every 32 edges: compare builds with and
+ * without OS_TIMESTAMP_ISR. The simulated micros() costs next to nothing,
+ * unlike micros() on a target.
+ *
+ * Revision history:
+ * - Oct. 2026: latency tool added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "OregonBridge.h"
+#include "PulseCapture.h"
+#include "PulseGenerator.h"
+
+using namespace PulseGenerator;
+
+static uint32_t readings = 0;
+
+static void osCallback(const Reading&) {
+  readings++;
+}
+
+static bool loadFile(const char* path, std::vector<uint32_t>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  std::vector<byte> capture;
+  byte buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof buf, f)) > 0) capture.insert(capture.end(), buf, buf + n);
+  fclose(f);
+
+  PulseCaptureReader reader(capture.data(), capture.size());
+  if (!reader.begin()) return false;
+  uint32_t width;
+  while (reader.next(width)) out.push_back(width);
+  return true;
+}
+
+/* Replays 'pulses' through the interrupt, calling loop() every 'delay' us */
+static void run(const std::vector<uint32_t>& pulses, uint32_t delay) {
+  OregonBridge* bridge = new OregonBridge;
+  bridge->registerCallback(osCallback);
+  readings = 0;
+
+  unsigned long t = 0, next = delay;
+  for (size_t i = 0; i < pulses.size(); i++) {
+    t += pulses[i];
+    // the sketch gets back to loop() at its own pace
+    while (delay && next <= t) {
+      setMicros(next);
+      bridge->loop();
+      next += delay;
+    }
+    setMicros(t);
+    bridge->externalInterrupt();
+    // no delay: loop() runs after every interrupt
+    if (!delay) bridge->loop();
+  }
+  bridge->loop();
+
+  // the overflow counter saturates: the queue losses are counted here too
+  const OregonStats& stats = bridge->getStats();
+  unsigned long lost = pulses.size() - stats.pulses;
+  uint16_t overflows = bridge->getOverflowCount();
+  printf("%8.1f ms %10lu %8.3f %%  %5s%-6u %8lu\n", delay / 1000.0, lost, 100.0 * lost / pulses.size(),
+         overflows == 0xffff ? ">=" : "", overflows, (unsigned long)readings);
+  delete bridge;
+}
+
+/* Host cost of the interrupt per edge, and of loop() per pulse (decoding included) */
+static void timeInterrupt(const std::vector<uint32_t>& pulses) {
+  double best[2] = {0, 0};
+  for (int r = 0; r < 5; r++) {
+    OregonBridge* bridge = new OregonBridge;
+    double seconds[2] = {0, 0};
+    unsigned long t = 0;
+    // batches small enough for the queue: every edge is queued
+    for (size_t i = 0; i < pulses.size(); i += 32) {
+      size_t end = i + 32 < pulses.size() ? i + 32 : pulses.size();
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (size_t j = i; j < end; j++) {
+        setMicros(t += pulses[j]);
+        bridge->externalInterrupt();
+      }
+      std::chrono::steady_clock::time_point queued = std::chrono::steady_clock::now();
+      bridge->loop();
+      seconds[0] += std::chrono::duration<double>(queued - start).count();
+      seconds[1] += std::chrono::duration<double>(std::chrono::steady_clock::now() - queued).count();
+    }
+    for (int k = 0; k < 2; k++)
+      if (r == 0 || seconds[k] < best[k]) best[k] = seconds[k];
+    delete bridge;
+  }
+  printf("interrupt: %.2f ns/edge, loop(): %.2f ns/pulse\n", best[0] * 1e9 / pulses.size(),
+         best[1] * 1e9 / pulses.size());
+}
+
+int main(int argc, char** argv) {
+  double seconds = 600;
+  const char* path = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-t") && i + 1 < argc)
+      seconds = atof(argv[++i]);
+    else
+      path = argv[i];
+  }
+  if (seconds <= 0) {
+    fprintf(stderr, "usage: %s [-t seconds] [capture.obpc]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint32_t> pulses;
+  if (path) {
+    if (!loadFile(path, pulses)) {
+      fprintf(stderr, "cannot read %s (or not a pulse capture)\n", path);
+      return 1;
+    }
+  } else {
+    Channel channel;
+    channel.idleNoise = true;
+    Generator generator(channel, 1);
+    generator.addSensor({THGR228N, 0x5b, 1, 215, 74, true}, 39, 2, 10000);
+    generator.addSensor({THN132N, 0x11, 2, -84, 0, true}, 41, 2, 10000);
+    generator.addSensor({GENERIC_V1, 3, 3, 123, 0, true}, 43, 1, 0);
+    generator.addSensor({THGR810, 0xc4, 1, -37, 55, true}, 53, 1, 0);
+    generator.generate(seconds, pulses);
+  }
+
+  printf("%lu pulses, queue of %u, %s interrupt\n", (unsigned long)pulses.size(), OS_PULSE_BUFFER_SIZE,
+#ifdef OS_TIMESTAMP_ISR
+         "timestamp-only"
+#else
+         "pulse width"
+#endif
+  );
+  printf("loop delay  pulses lost    rate  overflows  readings\n");
+  static const uint32_t delays[] = {0, 500, 1000, 2000, 5000, 10000, 15000, 20000, 30000, 50000, 100000};
+  for (size_t i = 0; i < sizeof delays / sizeof delays[0]; i++) run(pulses, delays[i]);
+  timeInterrupt(pulses);
+  return 0;
+}
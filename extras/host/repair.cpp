@@ -0,0 +1,151 @@
+/**
+ * repair.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file repair.cpp
+ * @brief Yield against false accepts of the single packet repair: noisy
+ * synthetic captures of known sensors, decoded by the bridge, every
+ * delivered reading checked against the values actually sent.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root, once with and once without the repair:
+ *
+ *    g++ -std=c++11 -O2 -DOS_BIT_REPAIR -Iextras/host -Isrc \
+ *        extras/host/repair.cpp src/OregonBridge.cpp -o repair
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/repair.cpp \
+ *        src/OregonBridge.cpp -o norepair
+ *
+ * Usage:
+ *
+ *    repair [-t seconds] [-r seeds]
+ *
+ *    -t seconds length of each capture (default 3600)
+ *    -r seeds   captures per channel setting, seeds 1 to 'seeds' (default 10)
+ *
+ * Each capture holds five sensors (v1, v2.1 and v3), or the v1 sensor
+ * alone, with receiver noise between transmissions; the channel settings add
+ * jitter, lost edges and noise bursts. A reading is wrong when no sensor
+ * sent it: its protocol, id, channel, temperature, humidity or battery
+ * differ from what every sensor sent.
+ * Readings are counted as delivered to the callback, repeats dropped.
+ *
+ * Revision history:
+ * - Oct. 2026: repair tool added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "OregonBridge.h"
+#include "PulseGenerator.h"
+
+using namespace PulseGenerator;
+
+static const Sensor sensors[] = {{THGR228N, 0x5b, 1, 215, 74, true},
+                                 {THN132N, 0x11, 2, -84, 0, true},
+                                 {GENERIC_V1, 5, 1, -34, 0, true},
+                                 {THGR810, 0xc4, 1, -37, 55, true},
+                                 {THN802, 0x2e, 2, 189, 0, true}};
+static const size_t sensorCount = sizeof sensors / sizeof sensors[0];
+
+static uint32_t delivered = 0, wrong = 0;
+
+static byte protocolOf(Model model) {
+  if (model == GENERIC_V1) return OS_PROTOCOL_ID_V1;
+  return isV3(model) ? OS_PROTOCOL_ID_V3 : OS_PROTOCOL_ID_V2;
+}
+
+/* true if one of the sensors sent exactly this reading */
+static bool isTrue(const Reading& r) {
+  for (size_t k = 0; k < sensorCount; k++) {
+    const Sensor& s = sensors[k];
+    if (protocolOf(s.model) != r.protocol || s.id != r.id || s.channel != r.channel) continue;
+    bool humidity = s.model == THGR228N || s.model == THGR810;
+    if (r.temperature == s.temperature && r.humidity == (humidity ? s.humidity : 0) && r.battery == s.battery)
+      return true;
+  }
+  return false;
+}
+
+static void osCallback(const Reading& r) {
+  delivered++;
+  if (!isTrue(r)) {
+    wrong++;
+    char t[8];
+    formatTenths(r.temperature, t, sizeof t);
+    printf("    wrong: %s id %u channel %u, %s C, %u %%, battery %s\n", r.modelName, r.id, r.channel, t,
+           r.humidity, r.battery ? "ok" : "low");
+  }
+}
+
+struct Setting {
+  const char* name;
+  double jitter, dropEdge, burst;
+  bool v1Alone;  // the v1 sensor only, no collisions
+};
+
+int main(int argc, char** argv) {
+  double seconds = 3600;
+  int seeds = 10;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "-t"))
+      seconds = atof(argv[i + 1]);
+    else if (!strcmp(argv[i], "-r"))
+      seeds = atoi(argv[i + 1]);
+  }
+  if (seconds <= 0 || seeds < 1) {
+    fprintf(stderr, "usage: %s [-t seconds] [-r seeds]\n", argv[0]);
+    return 2;
+  }
+
+  static const Setting settings[] = {{"jitter 60 us", 60, 0, 0, false},
+                                     {"jitter 80 us", 80, 0, 0, false},
+                                     {"jitter 100 us", 100, 0, 0, false},
+                                     {"jitter 80 us, drops 0.4 %, bursts 20 %", 80, 0.004, 0.2, false},
+                                     {"drops 0.4 %, bursts 20 %", 0, 0.004, 0.2, false},
+                                     {"v1 alone, jitter 80 us, drops 0.4 %, bursts 20 %", 80, 0.004, 0.2, true}};
+
+#ifdef OS_BIT_REPAIR
+  printf("single packet repair on, %d x %.0f s per setting\n", seeds, seconds);
+#else
+  printf("single packet repair off, %d x %.0f s per setting\n", seeds, seconds);
+#endif
+  for (size_t k = 0; k < sizeof settings / sizeof settings[0]; k++) {
+    const Setting& setting = settings[k];
+    printf("%s\n", setting.name);
+    uint32_t messages = 0, attempts = 0, repaired = 0;
+    delivered = wrong = 0;
+    for (int seed = 1; seed <= seeds; seed++) {
+      Channel channel;
+      channel.idleNoise = true;
+      channel.jitter = setting.jitter;
+      channel.dropEdge = setting.dropEdge;
+      channel.burst = setting.burst;
+      Generator generator(channel, seed);
+      generator.addSensor(sensors[2], 43, 1, 0);
+      if (!setting.v1Alone) {
+        generator.addSensor(sensors[0], 39, 2, 10000);
+        generator.addSensor(sensors[1], 41, 2, 10000);
+        generator.addSensor(sensors[3], 53, 1, 0);
+        generator.addSensor(sensors[4], 47, 1, 0);
+      }
+      Pulses pulses;
+      messages += generator.generate(seconds, pulses);
+
+      OregonBridge* bridge = new OregonBridge;
+      bridge->registerCallback(osCallback);
+      uint32_t t = 0;
+      // pulse times from the capture, for the repeat filter
+      for (size_t i = 0; i < pulses.size(); i++) bridge->feedPulse(pulses[i] > 0xffff ? 0xffff : pulses[i], t += pulses[i]);
+      attempts += bridge->getStats().repairAttempts;
+      repaired += bridge->getStats().repaired;
+      delete bridge;
+    }
+    printf("  %lu messages, %lu readings (%.2f %%), %lu wrong, repairs %lu of %lu attempts\n",
+           (unsigned long)messages, (unsigned long)delivered, 100.0 * delivered / messages, (unsigned long)wrong,
+           (unsigned long)repaired, (unsigned long)attempts);
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * replay.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file replay.cpp
+ * @brief Feeds a pulse capture (PulseCapture.h) through OregonBridge on a
+ * Linux host, as fast as possible, and reports decoding results and speed.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root:
+ *
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/replay.cpp \
+ *        src/OregonBridge.cpp -o replay
+ *
+ * Usage:
+ *
+ *    replay [-v] [-n repeat] [-a|-x model,channel,id] capture.obpc
+ *
+ *    -v         print every valid reading
+ *    -n repeat  replay the capture 'repeat' times (default 1)
+ *    -a key     only decode this sensor (repeatable), see SensorFilter.h
+ *    -x key     ignore this sensor (repeatable); '*' matches any value,
+ *               e.g. -x 0x1a2d,*,*
+ *
+ * Revision history:
+ * - Oct. 2026: replay tool added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "OregonBridge.h"
+#include "PulseCapture.h"
+
+static OregonBridge orbridge;
+static bool verbose = false;
+static uint32_t readings = 0;
+
+static void osCallback(const Reading& reading) {
+  readings++;
+  if (!verbose) return;
+
+  char t[8];
+  formatTenths(reading.temperature, t, sizeof t);
+  printf("%s id=%u ch=%u bat=%s temp=%s hum=%u\n", reading.modelName, reading.id, reading.channel,
+         reading.battery ? "good" : "low", t, reading.humidity);
+}
+
+static bool addFilter(char* arg, SensorFilter::Mode mode) {
+  word key[3];
+  char* field = strtok(arg, ",");
+  for (byte i = 0; i < 3; i++, field = strtok(NULL, ",")) {
+    if (!field) return false;
+    key[i] = strcmp(field, "*") ? (word)strtoul(field, NULL, 0) : SensorFilter::ANY;
+  }
+  orbridge.getFilter().setMode(mode);
+  return orbridge.getFilter().add(key[0], key[1], key[2]);
+}
+
+static bool loadFile(const char* path, std::vector<byte>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  byte buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof buf, f)) > 0) out.insert(out.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* path = NULL;
+  long repeat = 1;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-v"))
+      verbose = true;
+    else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+      repeat = atol(argv[++i]);
+    else if ((!strcmp(argv[i], "-a") || !strcmp(argv[i], "-x")) && i + 1 < argc) {
+      SensorFilter::Mode mode = argv[i][1] == 'a' ? SensorFilter::ALLOW : SensorFilter::DENY;
+      if (!addFilter(argv[++i], mode)) {
+        fprintf(stderr, "invalid filter: %s\n", argv[i]);
+        return 2;
+      }
+    }
+    else
+      path = argv[i];
+  }
+  if (!path || repeat < 1) {
+    fprintf(stderr, "usage: %s [-v] [-n repeat] [-a|-x model,channel,id] capture.obpc\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<byte> capture;
+  if (!loadFile(path, capture)) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return 1;
+  }
+
+  // decode the varints once, so that only the bridge is timed
+  std::vector<uint32_t> pulses;
+  PulseCaptureReader reader(capture.data(), capture.size());
+  if (!reader.begin()) {
+    fprintf(stderr, "%s: not a pulse capture (or unsupported version)\n", path);
+    return 1;
+  }
+  uint32_t width;
+  while (reader.next(width)) pulses.push_back(width);
+
+  orbridge.registerCallback(osCallback);
+
+  // packet times (repeat window) follow the capture, not the host clock
+  uint32_t t = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (long r = 0; r < repeat; r++)
+    for (size_t i = 0; i < pulses.size(); i++)
+      orbridge.feedPulse(pulses[i] > 0xffff ? 0xffff : pulses[i], t += pulses[i]);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const OregonStats& stats = orbridge.getStats();
+  printf("pulses:           %lu\n", (unsigned long)stats.pulses);
+  printf("decoder calls:    %lu\n", (unsigned long)stats.decoderCalls);
+  printf("packets:          %lu\n", (unsigned long)stats.packets);
+  printf("valid packets:    %lu\n", (unsigned long)readings);
+  printf("checksum errors:  %lu\n", (unsigned long)stats.checksumErrors);
+  printf("rejected early:   %lu\n", (unsigned long)stats.rejectedEarly);
+  printf("repeats dropped:  %lu\n", (unsigned long)stats.repeats);
+  printf("recovered:        %lu\n", (unsigned long)stats.recovered);
+  printf("repairs:          %lu of %lu\n", (unsigned long)stats.repaired, (unsigned long)stats.repairAttempts);
+#if OS_SENSOR_SLOTS > 0
+  printf("sensors:          %u\n", orbridge.getSensors().getCount());
+  if (verbose)
+    for (const SensorState& s : orbridge.getSensors())
+      printf("  %s sensor=%u ch=%u: id %u, %u packets, %u checksum errors\n", s.reading.modelName,
+             s.reading.sensorId, s.reading.channel, s.reading.id, s.packets, s.checksumErrors);
+#endif
+  printf("reidentified:     %lu\n", (unsigned long)stats.reidentified);
+  printf("time:             %.3f s\n", seconds);
+  printf("pulses/second:    %.0f\n", seconds > 0 ? stats.pulses / seconds : 0.0);
+  return 0;
+}
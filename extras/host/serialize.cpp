@@ -0,0 +1,178 @@
+/**
+ * serialize.cpp - This file is part of OregonBridge Arduino Library.
+ *
+ * @file serialize.cpp
+ * @brief Cost of serializing a Reading: formatReading() and printReading()
+ * against the usual Arduino String concatenation.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021 - MIT Licence
+ *
+ * Build, from the library root:
+ *
+ *    g++ -std=c++11 -O2 -Iextras/host -Isrc extras/host/serialize.cpp \
+ *        src/OregonBridge.cpp -o serialize
+ *
+ * Usage:
+ *
+ *    serialize [-n readings]
+ *
+ *    -n readings readings serialized per timed run (default 1000000)
+ *
+ * Prints one sample of every format, then ns/reading and heap allocations
+ * per reading of each approach. The host has no Arduino String: the one
+ * below grows its buffer the way WString does (realloc to the exact length
+ * on every concatenation, a temporary for every operand), so allocation
+ * counts match the target; times only compare approaches on this host.
+ *
+ * Revision history:
+ * - Oct. 2026: serialize tool added to OregonBridge library.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <utility>
+
+#include "Arduino.h"
+#include "OregonBridge.h"
+
+static unsigned long allocations = 0;
+
+/* Arduino String stand-in, see the file comment */
+class String {
+ public:
+  String(const char* s = "") { copy(s, strlen(s)); }
+  String(const String& s) { copy(s.buffer, s.len); }
+  String(String&& s) : buffer(s.buffer), len(s.len) { s.buffer = nullptr; }
+  explicit String(unsigned value) {
+    char tmp[12];
+    copy(tmp, snprintf(tmp, sizeof tmp, "%u", value));
+  }
+  ~String() { free(buffer); }
+
+  void concat(const char* s, size_t n) {
+    char* grown = (char*)realloc(buffer, len + n + 1);
+    allocations++;
+    buffer = grown;
+    memcpy(buffer + len, s, n + 1);
+    len += n;
+  }
+
+  String& operator+=(const String& rhs) {
+    concat(rhs.buffer, rhs.len);
+    return *this;
+  }
+
+  friend String operator+(String&& lhs, const String& rhs) {
+    lhs.concat(rhs.buffer, rhs.len);
+    return std::move(lhs);
+  }
+  friend String operator+(String&& lhs, const char* rhs) {
+    lhs.concat(rhs, strlen(rhs));
+    return std::move(lhs);
+  }
+  friend String operator+(const char* lhs, const String& rhs) {
+    return String(lhs) + rhs;
+  }
+
+  const char* c_str() const { return buffer; }
+  size_t length() const { return len; }
+
+ private:
+  void copy(const char* s, size_t n) {
+    buffer = (char*)malloc(n + 1);
+    allocations++;
+    memcpy(buffer, s, n + 1);
+    len = n;
+  }
+
+  char* buffer = nullptr;
+  size_t len = 0;
+};
+
+/* The JSON of READING_JSON, built the way sketches usually do */
+static String jsonString(const Reading& r) {
+  char temperature[8];
+  formatTenths(r.temperature, temperature, sizeof temperature);
+  String s = "{\"model\":\"" + String(r.modelName) + "\",\"protocol\":\"" + protocolName(r.protocol) +
+             "\",\"channel\":" + String(r.channel) + ",\"id\":" + String(r.id) +
+             ",\"sensor_id\":" + String(r.sensorId) + ",\"battery_ok\":" + (r.battery ? "true" : "false");
+  if (r.hasTemperature) s += ",\"temperature\":" + String(temperature);
+  if (r.hasHumidity) s += ",\"humidity\":" + String(r.humidity);
+  s += "}";
+  return s;
+}
+
+/* Discards the output, like a Print with nowhere to go */
+class NullPrint : public Print {
+ public:
+  size_t write(uint8_t /*c*/) { return 1; }
+  size_t write(const uint8_t* /*buffer*/, size_t size) { return size; }
+};
+
+// the readings cycle through these
+static const Reading samples[] = {
+    {0, "THGR228N", nullptr, 0x1a2d, 215, OS_PROTOCOL_ID_V2, 0x5b, 0x5b, 1, 74, true, 0, true, true},
+    {0, "THN132N", nullptr, 0xec40, -84, OS_PROTOCOL_ID_V2, 0x11, 0x11, 2, 0, true, 0, true, false},
+    {0, "Generic v1", nullptr, 0, 123, OS_PROTOCOL_ID_V1, 3, 3, 3, 0, false, 0, true, false},
+    {0, "THGR810", nullptr, 0xfa28, -37, OS_PROTOCOL_ID_V3, 0xc4, 0x2e, 1, 55, true, 0, true, true},
+    {0, "THGR228N", nullptr, 0x1a2d, 185, OS_PROTOCOL_ID_V2, 0x5b, 0x5b, 1, 0, true, 0, true, true},
+    {0, "UVN800", nullptr, 0xda78, 0, OS_PROTOCOL_ID_V3, 0x3c, 0x3c, 1, 0, true, 0, false, false}};
+static const size_t sampleCount = sizeof samples / sizeof samples[0];
+
+static volatile size_t sink;
+
+template <class F>
+static void run(const char* name, long n, F serialize) {
+  double best = 0;
+  unsigned long allocated = 0;
+  for (int r = 0; r < 5; r++) {
+    allocations = 0;
+    size_t total = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i++) total += serialize(samples[i % sampleCount]);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (r == 0 || seconds < best) best = seconds;
+    allocated = allocations;
+    sink = total;
+  }
+  printf("%-28s %7.1f ns/reading, %5.2f allocations/reading\n", name, best * 1e9 / n, (double)allocated / n);
+}
+
+int main(int argc, char** argv) {
+  long n = 1000000;
+  for (int i = 1; i + 1 < argc; i += 2)
+    if (!strcmp(argv[i], "-n")) n = atol(argv[i + 1]);
+  if (n < 1) {
+    fprintf(stderr, "usage: %s [-n readings]\n", argv[0]);
+    return 2;
+  }
+
+  printReading(samples[0], READING_JSON, Serial);
+  Serial.println();
+  printReading(samples[0], READING_LINE_PROTOCOL, Serial);
+  Serial.print(readingCsvHeader());
+  for (size_t i = 0; i < sampleCount; i++) printReading(samples[i], READING_CSV, Serial);
+  printf("JSON sizes:");
+  for (size_t i = 0; i < sampleCount; i++) printf(" %lu", (unsigned long)formatReading(samples[i], READING_JSON, nullptr, 0));
+  printf("\n\n");
+
+  run("String concatenation (JSON)", n, [](const Reading& r) { return jsonString(r).length(); });
+  run("formatReading (JSON)", n, [](const Reading& r) {
+    char buf[160];
+    return formatReading(r, READING_JSON, buf, sizeof buf);
+  });
+  run("formatReading (line)", n, [](const Reading& r) {
+    char buf[160];
+    return formatReading(r, READING_LINE_PROTOCOL, buf, sizeof buf);
+  });
+  run("formatReading (CSV)", n, [](const Reading& r) {
+    char buf[160];
+    return formatReading(r, READING_CSV, buf, sizeof buf);
+  });
+  static NullPrint out;
+  run("printReading (JSON)", n, [](const Reading& r) { return printReading(r, READING_JSON, out); });
+  return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * AdaptiveThreshold.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file AdaptiveThreshold.h
+ * @brief Short/long pulse threshold of a Manchester decoder, re-centred on
+ * the pulse widths actually received.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: AdaptiveThreshold added to OregonBridge library.
+ */
+
+#ifndef AdaptiveThreshold_h
+#define AdaptiveThreshold_h
+
+#include "Arduino.h"
+
+/**
+ * @brief Online k-means (k = 2) of the data pulse widths of a decoder. The
+ * short and long pulses each have a running mean, moved by 1/16 of the error
+ * on every data pulse of the packet; the threshold is half way between them,
+ * kept within [Min, Max] whatever the traffic.
+ *
+ * Each packet starts from the calibration, the means of the packets that
+ * passed their checksum (moved by 1/4 on each): noise and garbled frames never
+ * shift it. Within a packet the means follow the sensor's own clock, so this
+ * also works with several sensors whose clocks differ.
+ *
+ * Means are kept in quarters of a microsecond.
+ *
+ * @tparam Short nominal short pulse [us]
+ * @tparam Long nominal long pulse [us]
+ * @tparam Min lowest threshold [us]
+ * @tparam Max highest threshold [us]
+ */
+template <word Short, word Long, word Min, word Max>
+class AdaptiveThreshold {
+  static_assert(Short < Min && Min <= Max && Max < Long, "threshold limits must be between the pulse widths");
+  static_assert(Long < 16384, "pulse widths up to 16383 us");
+
+ public:
+  /* Widths from this one on are long pulses [us] */
+  word split() const { return threshold; }
+
+  /* A packet starts: means from the calibration */
+  void begin() {
+    shortMean = shortCal;
+    longMean = longCal;
+    update();
+  }
+
+  /**
+   * @brief A packet starts, its clock measured by the decoder (e.g. from a
+   * sync pulse): means from the nominal widths, scaled.
+   *
+   * @param shortWidth the short pulse width of this transmission [us]
+   */
+  void begin(word shortWidth) {
+    shortMean = shortWidth * 4;
+    longMean = (uint32_t)shortWidth * Long / Short * 4;
+    update();
+  }
+
+  /**
+   * @brief Adds a data pulse to its class.
+   *
+   * @param width the pulse width [us]
+   * @param w the class given by split(): 0 short, 1 long
+   */
+  void learn(word width, byte w) {
+    word& mean = w ? longMean : shortMean;
+    int32_t error = (int32_t)(width < 16383 ? width : 16383) * 4 - mean;
+    mean += error / 16;
+    update();
+  }
+
+  /* The packet passed its checksum: its means move the calibration */
+  void commit() {
+    shortCal += ((int32_t)shortMean - shortCal) / 4;
+    longCal += ((int32_t)longMean - longCal) / 4;
+  }
+
+  /* Calibrated short and long widths [us] */
+  word getShort() const { return shortCal / 4; }
+  word getLong() const { return longCal / 4; }
+
+ private:
+  word shortCal = Short * 4, longCal = Long * 4;
+  word shortMean = Short * 4, longMean = Long * 4;
+  word threshold = (Short + Long) / 2;
+
+  void update() {
+    word t = ((uint32_t)shortMean + longMean) / 8;
+    threshold = t < Min ? Min : t > Max ? Max : t;
+  }
+};
+
+#endif
@@ -39,11 +39,41 @@
 #ifndef DecodeOOK_h
 #define DecodeOOK_h
 
-class DecodeOOK {
- protected:
-  byte total_bits, bits, flip, state, pos, data[25];
+#include "AdaptiveThreshold.h"
+#include "SensorFilter.h"
+
+/* Size of the packet data buffer [bytes] */
+#define OOK_DATA_SIZE 25
 
-  virtual char decode(word width) = 0;
+/**
+ * @brief Inclusive range of pulse widths [us] a decoder may accept. Every
+ * decoder declares its ranges, so that pulses can be routed to it only when
+ * they can possibly be accepted (see PulseRouter).
+ */
+struct WidthRange {
+  word min, max;
+};
+
+/**
+ * @brief Decoder state and the protocol-independent helpers. This is the
+ * type-erased view of any decoder, e.g. as returned by Device::decoder().
+ */
+class DecodeOOKBase {
+ protected:
+  byte total_bits, bits, flip, state, pos, data[OOK_DATA_SIZE];
+  // bits of the byte being received, stored to data[pos] once complete
+  byte shift;
+  // running checksum, updated by the decoder as each byte completes
+  byte sum;
+  bool checksumOk;
+  // sensors to drop as soon as their header is in (none if null)
+  SensorFilter* filter = nullptr;
+#ifdef OS_BIT_REPAIR
+  // weakest data bit so far (index, pulse-width margin), the margin of the
+  // runner-up bit, see noteMargin()
+  byte weakBit;
+  word weakMargin, runnerUpMargin, pulseMargin;
+#endif
 
  public:
   enum { UNKNOWN,
@@ -54,21 +84,7 @@ class DecodeOOK {
          OK,
          DONE };
 
-  DecodeOOK() { resetDecoder(); }
-
-  bool nextPulse(word width) {
-    if (state != DONE)
-
-      switch (decode(width)) {
-        case -1:
-          resetDecoder();
-          break;
-        case 1:
-          done();
-          break;
-      }
-    return isDone();
-  }
+  DecodeOOKBase() { resetDecoder(); }
 
   bool isDone() const { return state == DONE; }
 
@@ -78,37 +94,92 @@ class DecodeOOK {
   }
 
   void resetDecoder() {
-    total_bits = bits = pos = flip = 0;
+    total_bits = bits = pos = flip = shift = sum = 0;
+    checksumOk = false;
     state = UNKNOWN;
+#ifdef OS_BIT_REPAIR
+    weakBit = 0xff;
+    weakMargin = runnerUpMargin = pulseMargin = 0xffff;
+#endif
   }
 
-  // add one bit to the packet data buffer
-  virtual void gotBit(char value) {
-    total_bits++;
-    byte* ptr = data + pos;
-    *ptr = (*ptr >> 1) | (value << 7);
+  /* Sensor filter checked by gotByte() once the header is in: nullptr for none */
+  void setFilter(SensorFilter* filter) { this->filter = filter; }
 
-    if (++bits >= 8) {
-      bits = 0;
-      if (++pos >= sizeof data) {
-        resetDecoder();
-        return;
-      }
+  /* true if the checksum, computed while the bytes arrived, matched (once done) */
+  bool isChecksumValid() const { return checksumOk; }
+
+#ifdef OS_BIT_REPAIR
+  /* Data bit decoded from the pulse closest to the short/long threshold (0xff if none) */
+  byte getWeakBit() const { return weakBit; }
+
+  /* Distance of that pulse to the threshold, and the same for the next weakest bit [us] */
+  word getWeakMargin() const { return weakMargin; }
+  word getRunnerUpMargin() const { return runnerUpMargin; }
+
+  // keeps the smallest distance to the short/long threshold among the pulses of a bit
+  void noteMargin(word width, word threshold) {
+    word margin = width > threshold ? width - threshold : threshold - width;
+    if (margin < pulseMargin) pulseMargin = margin;
+  }
+
+  // data bit 'index' is complete: it is the weakest if its pulses were the closest
+  void noteBit(byte index) {
+    if (pulseMargin < weakMargin) {
+      // v2.1 rates each data bit twice: the same bit is not its own runner-up
+      if (index != weakBit) runnerUpMargin = weakMargin;
+      weakMargin = pulseMargin;
+      weakBit = index;
+    } else if (pulseMargin < runnerUpMargin && index != weakBit) {
+      runnerUpMargin = pulseMargin;
     }
-    state = OK;
+    pulseMargin = 0xffff;
   }
+#endif
 
-  // store a bit using Manchester encoding
-  void manchester(char value) {
-    flip ^= value;  // manchester code, long pulse flips the bit
-    gotBit(flip);
+  /**
+   * @brief Preamble stage shared by the Manchester decoders: counts a run of
+   * pulses of one class in 'flip' (v2.1: long pulses, v3: short pulses).
+   *
+   * @param w the pulse class, 0 short or 1 long
+   * @param run the class of the preamble pulses
+   * @param min the least number of preamble pulses
+   * @return 0 while the run goes on, 1 on the first other pulse after at
+   * least 'min' of them, -1 if the run is too short (reset)
+   */
+  char preamble(byte w, byte run, byte min) {
+    if (w == run) {
+      ++flip;
+      return 0;
+    }
+    return min <= flip ? 1 : -1;
+  }
+
+  /**
+   * @brief A run of at least 'count' preamble pulses was seen by the shared
+   * front-end (PreambleFrontEnd): the decoder continues as if it had counted them.
+   */
+  void preambleSeen(byte count) { flip = count; }
+
+  /* true once a preamble and start bit are confirmed, until done or reset */
+  bool isSynchronized() const { return state != UNKNOWN; }
+
+  /* true when waiting for a preamble with nothing counted yet */
+  bool isIdle() const { return state == UNKNOWN && flip == 0; }
+
+  /**
+   * @brief Same effect as a pulse outside every declared WidthRange, without
+   * running decode(): the decoder resets, unless it is idle or done already.
+   */
+  void rejectPulse() {
+    if (state != DONE && !isIdle()) resetDecoder();
   }
 
   // move bits to the front so that all the bits are aligned to the end
   void alignTail(byte max = 0) {
     // align bits
     if (bits != 0) {
-      data[pos] >>= 8 - bits;
+      data[pos] = shift >> (8 - bits);
       for (byte i = 0; i < pos; ++i)
         data[i] = (data[i] >> bits) | (data[i + 1] << (8 - bits));
       bits = 0;
@@ -124,24 +195,94 @@ class DecodeOOK {
 
   void reverseBits() {
     for (byte i = 0; i < pos; ++i) {
-      byte b = data[i];
-      for (byte j = 0; j < 8; ++j) {
-        data[i] = (data[i] << 1) | (b & 1);
-        b >>= 1;
-      }
+      // swap nibbles, then bit pairs, then single bits
+      byte b = (data[i] << 4) | (data[i] >> 4);
+      b = ((b & 0xcc) >> 2) | ((b & 0x33) << 2);
+      data[i] = ((b & 0xaa) >> 1) | ((b & 0x55) << 1);
     }
   }
 
   void reverseNibbles() {
+    // a single 'swap' instruction per byte on AVR
     for (byte i = 0; i < pos; ++i)
       data[i] = (data[i] << 4) | (data[i] >> 4);
   }
+};
+
+/**
+ * @brief Pulse-level decoding, statically bound to the protocol decoder
+ * (CRTP): Derived provides 'char decode(word width)' and may hide gotBit(),
+ * gotByte(), flushTail(), gotPacket() and the preamble declaration.
+ * These are resolved at compile time and inline into nextPulse().
+ * 
+ * @tparam Derived the protocol decoder class
+ */
+template <class Derived>
+class DecodeOOK : public DecodeOOKBase {
+ public:
+  bool nextPulse(word width) {
+    if (state != DONE)
+
+      switch (derived().decode(width)) {
+        case -1:
+          resetDecoder();
+          break;
+        case 1:
+          done();
+          break;
+      }
+    return isDone();
+  }
+
+  // add one bit to the packet data buffer
+  void gotBit(char value) {
+#ifdef OS_BIT_REPAIR
+    noteBit(total_bits);
+#endif
+    total_bits++;
+    shift = (shift >> 1) | (value << 7);
+
+    if (++bits >= 8) {
+      data[pos] = shift;
+      bits = 0;
+      if (!derived().gotByte(pos) || ++pos >= sizeof data) {
+        resetDecoder();
+        return;
+      }
+    }
+    state = OK;
+  }
+
+  // store a bit using Manchester encoding
+  void manchester(char value) {
+    flip ^= value;  // manchester code, long pulse flips the bit
+    derived().gotBit(flip);
+  }
 
   void done() {
     while (bits)
-      gotBit(0);  // padding
+      derived().gotBit(0);  // padding
+    derived().flushTail();
+    if (checksumOk) derived().gotPacket();
     state = DONE;
   }
+
+  // store the bits of an incomplete last byte: none here, done() pads it
+  void flushTail() {}
+
+  // data[i] is complete (running checksum): return false to drop the packet
+  bool gotByte(byte /*i*/) { return true; }
+
+  // the packet is done and passed its checksum
+  void gotPacket() {}
+
+  // Preamble pulses for the shared front-end, see PreambleFrontEnd: none
+  // declared by default, the decoder then gets every pulse
+  static const byte preambleMin = 0;
+  static WidthRange preambleRange() { return {0, 0}; }
+
+ private:
+  Derived& derived() { return *static_cast<Derived*>(this); }
 };
 
 #endif
\ No newline at end of file
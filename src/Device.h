@@ -37,13 +37,35 @@
 #define Device_h
 
 #include "DecodeOOK.h"
+#include "Reading.h"
 
 #define OS_PROTOCOL_V1 "v1"
 #define OS_PROTOCOL_V2 "v2.1"
+#define OS_PROTOCOL_V3 "v3"
+
+/* Numeric protocol identifiers, as found in Reading::protocol */
+#define OS_PROTOCOL_ID_V1 1
+#define OS_PROTOCOL_ID_V2 2
+#define OS_PROTOCOL_ID_V3 3
+
+/* Version string of a numeric protocol identifier, e.g. "v2.1" */
+inline const char* protocolName(uint8_t protocol) {
+  switch (protocol) {
+    case OS_PROTOCOL_ID_V1:
+      return OS_PROTOCOL_V1;
+    case OS_PROTOCOL_ID_V2:
+      return OS_PROTOCOL_V2;
+    case OS_PROTOCOL_ID_V3:
+      return OS_PROTOCOL_V3;
+    default:
+      return "undefined";
+  }
+}
 
 class Device {
  protected:
-  DecodeOOK* dDecoder;
+  /* Type-erased view of the decoder owned by the concrete device */
+  DecodeOOKBase* dDecoder;
 
  public:
   Device() {}
@@ -59,14 +81,72 @@ class Device {
     return false;
   }
 
+  /**
+   * @brief Checksum of the packet the decoder has just completed, before the
+   * decoder is reset. Devices whose decoder checks the checksum while the
+   * bits arrive answer in O(1); the default validates the decoder buffer.
+   * 
+   * @return true if the decoded packet is valid
+   */
+  virtual bool isPacketValid() {
+    byte count;
+    return validateChecksum(dDecoder->getData(count));
+  }
+
+  /**
+   * @brief Sanity check of the values in a packet (digits, ranges), for
+   * packets repaired rather than received as they are.
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @return true if every value is possible for this device
+   */
+  virtual bool isPlausible(const byte* /*data*/) {
+    return true;
+  }
+
+  /**
+   * @brief Whether the model of the packet measures temperature (UV, wind and
+   * rain sensors do not).
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @return true if getTemperatureTenths() is meaningful
+   */
+  virtual bool hasTemperature(const byte* /*data*/) {
+    return false;
+  }
+
+  /**
+   * @brief Get the temperature value from the raw data array, as an integer
+   * number of tenths of degree (no floating point involved).
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @return int16_t, the computed temperature value [tenths of degree]
+   */
+  virtual int16_t getTemperatureTenths(const byte* /*data*/) {
+    return 0;
+  }
+
+#ifndef OS_NO_FLOAT
   /**
    * @brief Get float temperature value from the raw data array.
+   * Not available when OS_NO_FLOAT is defined.
    * 
    * @param data const byte* received via callback or dataToDecoder
    * @return float, the computed temperature value [degrees]
    */
   virtual float getTemperature(const byte* data) {
-    return 0.0;
+    return getTemperatureTenths(data) / 10.0;
+  }
+#endif
+
+  /**
+   * @brief Whether the model of the packet measures humidity.
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @return true if getHumidity() is meaningful
+   */
+  virtual bool hasHumidity(const byte* /*data*/) {
+    return false;
   }
 
   /**
@@ -122,17 +202,60 @@ class Device {
     return "UNKNOWN";
   }
 
-  bool nextPulse(word width) {
-    return this->dDecoder->nextPulse(width);
+  /**
+   * @brief Get the numeric model identifier of the remote, if the protocol
+   * carries one, or 0 otherwise.
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @return uint16_t, model identifier
+   */
+  virtual uint16_t getModelId(const byte* data) {
+    return 0;
   }
 
-  DecodeOOK* decoder() {
+  /**
+   * @brief Parse every field of a valid packet, once.
+   * 
+   * @param data const byte* received via callback or dataToDecoder
+   * @param reading the Reading to be filled ('time', 'data' and 'length' are
+   * left to the caller)
+   */
+  void read(const byte* data, Reading& reading) {
+    reading.modelName = getRemoteModel(data);
+    reading.model = getModelId(data);
+    reading.protocol = getProtocol();
+    reading.id = reading.sensorId = getId(data);
+    reading.channel = getChannel(data);
+    reading.battery = getBattery(data);
+    reading.hasHumidity = hasHumidity(data);
+    // the humidity nibbles of other models hold something else
+    reading.humidity = reading.hasHumidity ? getHumidity(data) : 0;
+    reading.temperature = getTemperatureTenths(data);
+    reading.hasTemperature = hasTemperature(data);
+  }
+
+  /**
+   * @brief Feed one pulse to the device decoder.
+   * 
+   * @param width the pulse length [us]
+   * @return true when a complete packet is available in decoder()
+   */
+  virtual bool nextPulse(word /*width*/) {
+    return false;
+  }
+
+  DecodeOOKBase* decoder() {
     return dDecoder;
   }
 
   virtual const char* getOsVersion(void) {
     return "undefined";
   }
+
+  /* Numeric protocol identifier (OS_PROTOCOL_ID_*), 0 if undefined */
+  virtual uint8_t getProtocol(void) {
+    return 0;
+  }
 };
 
 #endif
\ No newline at end of file
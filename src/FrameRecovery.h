@@ -0,0 +1,234 @@
+/**
+ * FrameRecovery.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file FrameRecovery.h
+ * @brief Repairs packets failing the checksum with their repeated copies.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: FrameRecovery added to OregonBridge library.
+ */
+
+#ifndef FrameRecovery_h
+#define FrameRecovery_h
+
+#include "Arduino.h"
+#include "Device.h"
+
+/* Failed frames are kept this long, waiting for another copy [ms] */
+#ifndef OS_RECOVERY_WINDOW_MS
+#define OS_RECOVERY_WINDOW_MS 1000
+#endif
+
+/* Two copies are merged only if they differ in at most this many bits */
+#ifndef OS_RECOVERY_MAX_BITS
+#define OS_RECOVERY_MAX_BITS 4
+#endif
+
+/**
+ * @brief Keeps the last frames failing the checksum, and repairs them when
+ * another copy of the same message arrives: Oregon sensors send every
+ * message at least twice, and noise rarely hits two copies on the same bits.
+ *
+ * - Two copies: the bits on which they differ are mixed in every possible
+ *   way (at most OS_RECOVERY_MAX_BITS of them), and a run of differing bits
+ *   is read as a Manchester phase error (see merge()). The frame is repaired
+ *   only if exactly one candidate passes the checksum: with a sum checksum,
+ *   several passing candidates mean the sum cannot tell which one is right.
+ * - Three copies: bitwise majority vote, accepted if it passes the checksum.
+ *
+ * The sum checksum alone lets frames of two sensors sharing a device mix:
+ * copies are combined only if their model, channel and id agree, and a
+ * repaired frame must also be plausible (Device::isPlausible()).
+ *
+ * Two frames are kept, for any device; no heap.
+ */
+class FrameRecovery {
+ public:
+  /* A valid copy arrived: the failed ones of 'device' are of no use anymore */
+  void forget(const Device* device) {
+    for (byte i = 0; i < 2; i++)
+      if (this->frames[i].device == device) this->frames[i].device = nullptr;
+  }
+
+  /**
+   * @brief Tries to repair a frame failing the checksum with the failed
+   * copies kept for the same sensor. If it cannot, the frame is kept.
+   *
+   * @param device the device which decoded the frame
+   * @param data the frame (OOK_DATA_SIZE bytes), replaced by the repaired one
+   * @param length number of bytes received, updated on repair
+   * @param time receive time [us]
+   * @return true if 'data' now passes the checksum
+   */
+  bool recover(Device* device, byte* data, byte& length, uint32_t time) {
+    Frame* copies[2];
+    byte count = 0;
+    for (byte i = 0; i < 2; i++) {
+      Frame& f = this->frames[i];
+      if (f.device == device && time - f.time < OS_RECOVERY_WINDOW_MS * 1000UL && sameSensor(device, data, f.data))
+        copies[count++] = &f;
+    }
+    // most recent first
+    if (count == 2 && copies[1]->time - copies[0]->time < 0x80000000UL) {
+      Frame* t = copies[0];
+      copies[0] = copies[1];
+      copies[1] = t;
+    }
+
+    bool repaired = count == 2 && vote(device, data, length, *copies[0], *copies[1]);
+    for (byte i = 0; i < count && !repaired; i++) repaired = merge(device, data, length, *copies[i]);
+
+    if (repaired) {
+      forget(device);
+      return true;
+    }
+    keep(device, data, length, time);
+    return false;
+  }
+
+ private:
+  struct Frame {
+    Device* device;
+    uint32_t time;
+    byte length;
+    byte data[OOK_DATA_SIZE];
+  };
+
+  Frame frames[2] = {};
+
+  /* Stores a failed frame over an unused slot, else over the oldest one */
+  void keep(Device* device, const byte* data, byte length, uint32_t time) {
+    Frame* slot = &this->frames[0];
+    if (slot->device && (!this->frames[1].device || time - this->frames[1].time > time - slot->time))
+      slot = &this->frames[1];
+    slot->device = device;
+    slot->time = time;
+    slot->length = length;
+    memcpy(slot->data, data, OOK_DATA_SIZE);
+  }
+
+  /* Same model, channel and id in both frames: copies of one sensor's message */
+  static bool sameSensor(Device* device, const byte* a, const byte* b) {
+    return device->getModelId(a) == device->getModelId(b) && device->getChannel(a) == device->getChannel(b) &&
+           device->getId(a) == device->getId(b);
+  }
+
+  /* Majority of three copies; 'data' is replaced if it passes the checksum */
+  bool vote(Device* device, byte* data, byte& length, const Frame& b, const Frame& c) {
+    byte voted[OOK_DATA_SIZE];
+    for (byte i = 0; i < OOK_DATA_SIZE; i++)
+      voted[i] = (data[i] & b.data[i]) | (data[i] & c.data[i]) | (b.data[i] & c.data[i]);
+    if (!device->validateChecksum(voted) || !device->isPlausible(voted)) return false;
+    memcpy(data, voted, OOK_DATA_SIZE);
+    if (b.length > length) length = b.length;
+    return true;
+  }
+
+  /**
+   * @brief Candidates from two copies; 'data' is replaced by the only one
+   * passing the checksum:
+   * - few differing bits: every mix of the two copies;
+   * - one run of differing bits: an edge lost or added by noise flips the
+   *   Manchester phase, i.e. inverts every bit after it. If each copy has
+   *   its bits inverted after one of the run ends, inverting the bits of one
+   *   copy after either end gives the original frame.
+   */
+  bool merge(Device* device, byte* data, byte& length, const Frame& other) {
+    // differing bits, in the order of reception, over the bytes both copies received
+    byte n = length < other.length ? length : other.length;
+    byte bits[OS_RECOVERY_MAX_BITS];
+    word count = 0, first = 0, last = 0;
+    for (byte i = 0; i < n; i++) {
+      byte diff = data[i] ^ other.data[i];
+      for (byte j = 0; diff; j++, diff >>= 1) {
+        if (!(diff & 1)) continue;
+        word pos = (i << 3) | j;
+        if (count < OS_RECOVERY_MAX_BITS) bits[count] = pos;
+        if (!count++) first = pos;
+        last = pos;
+      }
+    }
+    if (!count) return false;
+
+    byte candidate[OOK_DATA_SIZE];
+    Search search;
+    search.solutions = 0;
+
+    if (count <= OS_RECOVERY_MAX_BITS) {
+      // walk every mix in Gray code order: one bit flipped per step
+      memcpy(candidate, data, OOK_DATA_SIZE);
+      word all = (1 << count) - 1;
+      for (word step = 1; step <= all; step++) {
+        byte k = 0;
+        while (!((step >> k) & 1)) k++;
+        candidate[bits[k] >> 3] ^= 1 << (bits[k] & 7);
+        // the mix equal to 'other' failed already
+        if ((step ^ (step >> 1)) != all) check(device, candidate, search);
+      }
+    }
+
+    if (last - first + 1 == count) {
+      for (byte e = 0; e < 2; e++) {
+        memcpy(candidate, data, OOK_DATA_SIZE);
+        invertFrom(candidate, e ? last + 1 : first, n);
+        check(device, candidate, search);
+      }
+    }
+
+    if (search.solutions != 1) return false;
+    memcpy(data, search.found, OOK_DATA_SIZE);
+    if (other.length > length) length = other.length;
+    return true;
+  }
+
+  /* Inverts the bits received from bit 'pos' to the end of byte 'n - 1' */
+  static void invertFrom(byte* data, word pos, byte n) {
+    byte i = pos >> 3;
+    if (i >= n) return;
+    data[i] ^= 0xff << (pos & 7);
+    while (++i < n) data[i] ^= 0xff;
+  }
+
+  /* Candidates passing the checksum in merge(): how many, and the first */
+  struct Search {
+    byte solutions;
+    byte found[OOK_DATA_SIZE];
+  };
+
+  /* Counts distinct plausible candidates passing the checksum */
+  static void check(Device* device, const byte* candidate, Search& search) {
+    if (search.solutions > 1 || !device->validateChecksum(candidate) || !device->isPlausible(candidate)) return;
+    if (!search.solutions)
+      memcpy(search.found, candidate, OOK_DATA_SIZE);
+    else if (!memcmp(search.found, candidate, OOK_DATA_SIZE))
+      return;
+    search.solutions++;
+  }
+};
+
+#endif
@@ -48,76 +48,212 @@
 #include "Arduino.h"
 
 /**
- * @brief Construct a new Oregon Bridge:: Oregon Bridge object 
+ * @brief Takes the next pulse recorded by the interrupt, if any.
  */
-OregonBridge::OregonBridge(void) {
-  INCLUDE_ALL_DEVICES
+bool OregonBridgeCore::popPulse(word& p) {
+#ifdef OS_TIMESTAMP_ISR
+  uint32_t t;
+  while (this->pulses.pop(t))
+    if (edgeToPulse(t, p)) {
+      this->stats.pulses++;
+      return true;
+    }
+  return false;
+#else
+  if (!this->pulses.pop(p)) return false;
+  this->stats.pulses++;
+  return true;
+#endif
 }
 
-/**
- * @brief Add supported devices and decoders to the devices array - via macro. * 
- * @tparam T (extends Device) the class of the device to be added.
- */
-template <class T>
-void OregonBridge::addDevice() {
-  if (this->devicesCount >= DEVICES_NUM) return;
-  devices[this->devicesCount] = new T;
-  this->devicesCount++;
+#ifdef OS_TIMESTAMP_ISR
+bool OregonBridgeCore::edgeToPulse(uint32_t t, word& p) {
+#if OS_GLITCH_FILTER_US > 0
+  // Two edges this close are a glitch: drop both, the current pulse goes on
+  if (this->hasPendingEdge && t - this->pendingEdge < OS_GLITCH_FILTER_US) {
+    this->hasPendingEdge = false;
+    return false;
+  }
+  bool ready = this->hasPendingEdge;
+  uint32_t end = this->pendingEdge;
+  this->pendingEdge = t;
+  this->hasPendingEdge = true;
+  if (!ready) return false;
+#else
+  uint32_t end = t;
+#endif
+
+  // determine the pulse length in microseconds, for either polarity
+  uint32_t width = end - this->lastEdge;
+  this->lastEdge = end;
+  this->pulseTime = end;
+
+  // very long pulses must not wrap around into the valid ranges
+  p = width > 0xffff ? 0xffff : (word)width;
+  return true;
 }
+#endif
 
-/**
- * @brief Main loop. Checks the pulse value recored by the interrupt and decodes
- * the message - if any. 
- */
-void OregonBridge::loop(void) {
-  // deactivate interrupts to avoid issues while handling data
-  noInterrupts();
+void OregonBridgeCore::packetReceived(Device* d) {
+  this->stats.packets++;
+  // Checked by the decoder while receiving: ask before it is reset
+  bool valid = d->isPacketValid();
+#ifdef OS_BIT_REPAIR
+  const DecodeOOKBase* decoder = d->decoder();
+  byte weakBit = decoder->getWeakBit();
+  word weakMargin = decoder->getWeakMargin(), runnerUpMargin = decoder->getRunnerUpMargin();
+#endif
+  const byte* dataDecoded = dataToDecoder(d);
+#ifdef OS_TIMESTAMP_ISR
+  this->packetTime = this->pulseTime;
+#else
+  this->packetTime = this->pulseTimeSet ? this->pulseTime : micros();
+#endif
 
-  word p = this->pulse;
-  this->pulse = 0;
+  // Validate payload via checksum. If invalid, do not proceed
+  if (!valid) {
+    this->stats.checksumErrors++;
+#if OS_SENSOR_SLOTS > 0
+    // the fields may be wrong too: only known sensors are counted
+    byte protocol = d->getProtocol(), channel = d->getChannel(dataDecoded);
+    word model = d->getModelId(dataDecoded);
+    this->sensors.failed(protocol, model, channel, sensorIdOf(protocol, model, channel, d->getId(dataDecoded)));
+#endif
+#ifdef OS_BIT_REPAIR
+    // unless the packet can be fixed at its weakest bit
+    valid = repairPacket(d, weakBit, weakMargin, runnerUpMargin);
+#endif
+#ifdef OS_FRAME_RECOVERY
+    // or other copies of the message make up for the errors
+    if (!valid && this->recovery.recover(d, this->staged, this->stagedLength, this->packetTime)) {
+      valid = true;
+      this->stats.recovered++;
+    }
+#endif
+    if (!valid) return;
+  }
+#ifdef OS_FRAME_RECOVERY
+  else {
+    this->recovery.forget(d);
+  }
+#endif
 
-  if (p == 0) {
-    interrupts();
+  // Drop repeats of a packet just delivered (same sensor, same payload)
+  byte protocol = d->getProtocol(), channel = d->getChannel(dataDecoded), id = d->getId(dataDecoded);
+  word model = d->getModelId(dataDecoded);
+  uint32_t key = RepeatFilter::sensorKey(protocol, model, channel, id);
+  if (this->repeatFilter.isRepeat(key, dataDecoded, this->stagedLength, this->packetTime)) {
+    this->stats.repeats++;
+#if OS_SENSOR_SLOTS > 0
+    this->sensors.repeated(protocol, model, channel, sensorIdOf(protocol, model, channel, id), this->packetTime);
+#endif
     return;
   }
 
-  // loop on every available device
-  for (uint8_t kk = 0; kk < devicesCount; kk++) {
-    Device* d = devices[kk];
-    if (!d->nextPulse(p)) continue;
+  // Invoke user callback function if not nullpntr
+  if (this->usrCallbackfunc) this->usrCallbackfunc(d, dataDecoded);
+
+#if !defined(OS_DEBUG) && OS_SENSOR_SLOTS == 0 && OS_REID_SLOTS == 0
+  if (!this->usrReadingCallbackfunc) return;
+#endif
+
+  // Parse the packet once for every consumer
+  Reading reading;
+  d->read(dataDecoded, reading);
+  reading.time = this->packetTime;
+  reading.data = dataDecoded;
+  reading.length = this->stagedLength;
+#if OS_REID_SLOTS > 0
+  reading.sensorId = this->registry.identify(reading);
+#endif
+
+#if OS_SENSOR_SLOTS > 0
+  // the table is up to date when the callback runs
+  this->sensors.store(reading);
+#endif
 
-    const byte* dataDecoded = dataToDecoder(d);
+  if (this->usrReadingCallbackfunc) this->usrReadingCallbackfunc(reading);
 
-    // Validate payload via checksum. If invalid, do not proceed
-    if (!d->validateChecksum(dataDecoded)) continue;
+  // Print info to serial
+  printDetails(d, reading);
+}
 
-    // Invoke user callback function if not nullpntr
-    if (this->usrCallbackfunc) this->usrCallbackfunc(d, dataDecoded);
+#ifdef OS_BIT_REPAIR
+bool OregonBridgeCore::repairPacket(Device* d, byte weakBit, word weakMargin, word runnerUpMargin) {
+  if (weakBit >= this->stagedLength * 8) return false;
+  this->stats.repairAttempts++;
 
-    // Print info to serial
-    printDetails(d, dataDecoded);
-  }
-  interrupts();
+  // only a bit clearly weaker than every other one is a likely culprit
+  if ((uint32_t)weakMargin * OS_REPAIR_MARGIN_RATIO > runnerUpMargin) return false;
+
+  byte work[OOK_DATA_SIZE];
+  memcpy(work, this->staged, sizeof work);
+  work[weakBit >> 3] ^= 1 << (weakBit & 0x07);
+  if (!d->validateChecksum(work) || !d->isPlausible(work)) return false;
+
+  // a sum checksum also passes with other errors: the fix must agree with the
+  // last reading of a known sensor
+  Reading fixed;
+  d->read(work, fixed);
+  const SensorState* s = this->sensors.find(fixed.protocol, fixed.model, fixed.channel,
+                                            sensorIdOf(fixed.protocol, fixed.model, fixed.channel, fixed.id));
+  if (!s) return false;
+  const Reading& last = s->reading;
+  int16_t dt = fixed.temperature - last.temperature, dh = fixed.humidity - last.humidity;
+  if (dt < -OS_REPAIR_MAX_DELTA || dt > OS_REPAIR_MAX_DELTA || dh < -5 || dh > 5 || fixed.battery != last.battery)
+    return false;
+
+  memcpy(this->staged, work, sizeof work);
+  this->stats.repaired++;
+  return true;
 }
+#endif
 
 /**
  * @brief Interrups function. Must be called by the main sketch when a change
  * on the RF receiver signal pin is detected.
- * The function determines the length of the pulses in the incoming message. 
+ * The function determines the length of the pulses in the incoming message
+ * and queues it for loop(). With OS_TIMESTAMP_ISR it only queues the time of
+ * the edge, the length is computed in loop(). 
  */
-void OregonBridge::externalInterrupt(void) {
+void OregonBridgeCore::externalInterrupt(void) {
+#ifdef OS_TIMESTAMP_ISR
+  this->pulses.push(micros());
+#else
   static word last;
   // determine the pulse length in microseconds, for either polarity
-  pulse = micros() - last;
-  last += this->pulse;
+  word p = micros() - last;
+  last += p;
+  this->pulses.push(p);
+#endif
+}
+
+void OregonBridgeCore::resetStats(void) {
+  memset(&this->stats, 0, sizeof this->stats);
+  this->filter.rejected = 0;
+#if OS_REID_SLOTS > 0
+  this->registry.reidentified = 0;
+#endif
+}
+
+uint16_t OregonBridgeCore::getOverflowCount(void) {
+  // 16 bit counter written by the interrupt: read it atomically
+  noInterrupts();
+  uint16_t count = this->pulses.getOverflowCount();
+  interrupts();
+  return count;
 }
 
 // Decode data once
-const byte* OregonBridge::dataToDecoder(Device* device) {
-  DecodeOOK* decoder = device->decoder();
+const byte* OregonBridgeCore::dataToDecoder(Device* device) {
+  DecodeOOKBase* decoder = device->decoder();
   byte pos;
   const byte* data = decoder->getData(pos);
 
+  // copy the whole buffer: checksums may look past the last complete byte
+  memcpy(this->staged, data, sizeof this->staged);
+  this->stagedLength = pos;
+
 #ifdef OS_DEBUG
   Serial.println("\n--- Signal received ---");
   Serial.print("Raw Hexadecimal data from sensor: ");
@@ -129,22 +265,44 @@ const byte* OregonBridge::dataToDecoder(Device* device) {
 #endif
 
   decoder->resetDecoder();
-  return data;
+  return this->staged;
 }
 
-void OregonBridge::registerCallback(osCallbackFunc callbackFunction) {
+void OregonBridgeCore::registerCallback(osCallbackFunc callbackFunction) {
   this->usrCallbackfunc = callbackFunction;
 }
 
-void OregonBridge::printDetails(Device* d, const byte* data) {
+void OregonBridgeCore::registerCallback(osReadingCallbackFunc callbackFunction) {
+  this->usrReadingCallbackfunc = callbackFunction;
+}
+
+void OregonBridgeCore::printDetails(Device* d, const Reading& r) {
 #ifdef OS_DEBUG
-  Serial.println("\n--- Found remote - model " + String(d->getRemoteModel(data)) + " ---");
-  Serial.println("Version: \tOS " + String(d->getOsVersion()));
-  Serial.print("ID: \t\t" + String(d->getId(data)) + ", HEX ");
-  Serial.println(d->getId(data), HEX);
-  Serial.println("Channel: \t" + String(d->getChannel(data)));
-  Serial.println("Battery level: \t" + (d->getBattery(data) ? String("good") : String("low")));
-  Serial.println("Temperature: \t" + String(d->getTemperature(data)) + "°C");
-  Serial.println("Humidity: \t" + String(d->getHumidity(data)) + "%");
+  char temperature[8];
+  formatTenths(r.temperature, temperature, sizeof temperature);
+
+  Serial.print(F("\n--- Found remote - model "));
+  Serial.print(r.modelName);
+  Serial.println(F(" ---"));
+  Serial.print(F("Version: \tOS "));
+  Serial.println(d->getOsVersion());
+  Serial.print(F("ID: \t\t"));
+  Serial.print(r.id);
+  Serial.print(F(", HEX "));
+  Serial.println(r.id, HEX);
+  Serial.print(F("Channel: \t"));
+  Serial.println(r.channel);
+  Serial.print(F("Battery level: \t"));
+  Serial.println(r.battery ? F("good") : F("low"));
+  if (r.hasTemperature) {
+    Serial.print(F("Temperature: \t"));
+    Serial.print(temperature);
+    Serial.println(F("°C"));
+  }
+  if (r.hasHumidity) {
+    Serial.print(F("Humidity: \t"));
+    Serial.print(r.humidity);
+    Serial.println(F("%"));
+  }
 #endif
 }
\ No newline at end of file
@@ -49,23 +49,245 @@
 /* Enable/disable debug logging */
 // #define OS_DEBUG
 
+/* Exclude floating point: Device::getTemperature() is compiled out, only the
+integer getTemperatureTenths() and formatTenths() remain (saves soft-float on AVR) */
+// #define OS_NO_FLOAT
+
+/* Decode with interrupts enabled: only the pulse hand-off from the interrupt is
+atomic. Comment out to keep interrupts disabled while decoding (legacy behaviour) */
+#define OS_ATOMIC_HANDOFF_ONLY
+
+/* Timestamp-only interrupt: the ISR just queues raw micros() values, pulse
+widths are computed (and glitches filtered) in loop(). Shortest possible ISR,
+twice the queue RAM. Also gives each packet an accurate receive time. */
+// #define OS_TIMESTAMP_ISR
+
+/* Timestamp mode only: edge pairs closer than this are discarded as a glitch
+and the surrounding pulse is kept whole [us]. 0 disables the filter. With the
+filter, each edge is held back until the next one proves it is no glitch: every
+pulse, hence every packet, is decoded one edge later (its time is unchanged) */
+#ifndef OS_GLITCH_FILTER_US
+#define OS_GLITCH_FILTER_US 0
+#endif
+
+/* Preamble lock: the first decoder to synchronize on a preamble takes an
+exclusive lock until its packet is done or it resets; meanwhile the other
+decoders are skipped (less CPU per pulse, no false starts inside the packet) */
+// #define OS_PREAMBLE_LOCK
+
+/* Repeats of a valid packet received within this time are dropped before the
+callback (v2.1 sensors send every message twice) [ms]. 0 disables. Can be changed
+at runtime with setRepeatWindow(). OS_REPEAT_SLOTS sensors are tracked (power of 2) */
+#ifndef OS_REPEAT_WINDOW_MS
+#define OS_REPEAT_WINDOW_MS 2000
+#endif
+#ifndef OS_REPEAT_SLOTS
+#define OS_REPEAT_SLOTS 8
+#endif
+
+/* Repair of packets failing the checksum with their repeated copies: failed
+frames are kept for OS_RECOVERY_WINDOW_MS, and merged or voted with the next
+copies (see FrameRecovery.h). About 70 bytes of RAM */
+// #define OS_FRAME_RECOVERY
+
+/* v2.1 sends every data bit followed by its inverse: check each pair and drop
+the frame on the first mismatch, freeing the decoder for the next preamble
+instead of waiting for the checksum to fail */
+// #define OS_V2_PAIR_CHECK
+
+/* Single packet repair: when the checksum fails, the data bit read from the
+pulse closest to the short/long threshold is flipped, if that pulse was at
+least OS_REPAIR_MARGIN_RATIO times closer than the pulses of any other bit.
+The fix must pass the checksum and the plausibility checks of the device, and
+agree with the last reading of a known sensor (sensor table): temperature
+within OS_REPAIR_MAX_DELTA tenths of degree, humidity within 5 %, same battery */
+// #define OS_BIT_REPAIR
+#ifndef OS_REPAIR_MARGIN_RATIO
+#define OS_REPAIR_MARGIN_RATIO 2
+#endif
+#ifndef OS_REPAIR_MAX_DELTA
+#define OS_REPAIR_MAX_DELTA 10
+#endif
+
+/* Adaptive short/long thresholds: each decoder follows the mean short and long
+pulse widths it receives and splits half way between them, within safe limits
+(see AdaptiveThreshold.h); v1 also scales its sync windows to the clock of each
+transmission. For sensors or receivers with skewed timing */
+// #define OS_ADAPTIVE_THRESHOLDS
+
+/* Shared preamble front-end: the preambles of every decoder are recognized in
+a single pass, and a decoder only gets pulses from its preamble to the end of
+its packet (see PreambleFrontEnd.h). 0 feeds every pulse to every decoder */
+#ifndef OS_PREAMBLE_FRONTEND
+#define OS_PREAMBLE_FRONTEND 1
+#endif
+
+/* Capacity of the sensor table, see OregonBridgeCore::getSensors() (power of 2,
+about 26 bytes of RAM each on AVR). 0 disables the table */
+#ifndef OS_SENSOR_SLOTS
+#define OS_SENSOR_SLOTS 8
+#endif
+#if defined(OS_BIT_REPAIR) && OS_SENSOR_SLOTS == 0
+#error "OS_BIT_REPAIR checks its fixes against the sensor table: OS_SENSOR_SLOTS must not be 0"
+#endif
+
+/* Re-identification of rolling ids: sensors pick a new random id when their
+batteries are changed. A new id on a known (model, channel) takes over the
+Reading::sensorId of the old one once the old id has been silent for
+OS_REID_SILENCE_MS (several transmission periods), if its temperature is within
+OS_REID_MAX_DELTA tenths of degree of the last one (models without temperature
+or humidity never take over); the old id takes it back if heard again.
+OS_REID_SLOTS pairs are tracked (power of 2, about 13 bytes of RAM each on
+AVR), 0 disables */
+#ifndef OS_REID_SLOTS
+#define OS_REID_SLOTS 0
+#endif
+#ifndef OS_REID_SILENCE_MS
+#define OS_REID_SILENCE_MS 300000
+#endif
+#ifndef OS_REID_MAX_DELTA
+#define OS_REID_MAX_DELTA 20
+#endif
+
+/* Capacity of the sensor filter, see OregonBridgeCore::getFilter() */
+#ifndef OS_FILTER_SIZE
+#define OS_FILTER_SIZE 8
+#endif
+
+/* Capacity of the pulse queue between the interrupt and loop() (power of 2, max 128) */
+#ifndef OS_PULSE_BUFFER_SIZE
+#define OS_PULSE_BUFFER_SIZE 64
+#endif
+
 #include "Arduino.h"
+#include "FrameRecovery.h"
+#include "PreambleFrontEnd.h"
+#include "PulseRing.h"
+#include "RepeatFilter.h"
+#include "PulseRouter.h"
+#include "ReadingFormat.h"
+#include "SensorRegistry.h"
+#include "SensorTable.h"
 #include "SupportedDevices.h"
 
-class OregonBridge {
+/**
+ * @brief Counters of the decoding pipeline, see OregonBridgeCore::getStats().
+ */
+struct OregonStats {
+  /* Pulses taken from the queue */
+  uint32_t pulses;
+
+  /* Pulses actually handed to a decoder (one per decoder) */
+  uint32_t decoderCalls;
+
+  /* Packets completed by a decoder */
+  uint32_t packets;
+
+  /* Completed packets failing checksum validation */
+  uint32_t checksumErrors;
+
+  /* Preamble locks taken and released (OS_PREAMBLE_LOCK) */
+  uint32_t lockAcquisitions;
+  uint32_t lockReleases;
+
+  /* Packets dropped by the sensor filter as soon as their header was in */
+  uint32_t rejectedEarly;
+
+  /* Valid packets dropped as repeats of one just delivered */
+  uint32_t repeats;
+
+  /* Failed packets repaired with their repeated copies (OS_FRAME_RECOVERY) */
+  uint32_t recovered;
+
+  /* Failed packets the single packet repair was tried on, and fixed (OS_BIT_REPAIR) */
+  uint32_t repairAttempts;
+  uint32_t repaired;
+
+  /* New sensor ids mapped to a known sensor (battery change, OS_REID_SLOTS) */
+  uint32_t reidentified;
+};
+
+/**
+ * @brief Device-independent part of the bridge: pulse queue, interrupt,
+ * packet hand-off to the user callback. Compiled once in OregonBridge.cpp.
+ */
+class OregonBridgeCore {
  public:
+  /* */
+  void externalInterrupt(void);
+
   /**
-   * @brief Construct a new Oregon Bridge object
+   * @brief Number of pulses dropped because loop() did not drain the queue
+   * in time. If it grows, call loop() more often or raise OS_PULSE_BUFFER_SIZE.
+   *
+   * @return uint16_t, the dropped pulses count (saturating)
    */
-  OregonBridge(void);
+  uint16_t getOverflowCount(void);
 
   /**
-   * @brief Main library function. Must be called each loop to check new data.
+   * @brief Receive time of the last decoded packet, i.e. the micros() value of
+   * its final edge with OS_TIMESTAMP_ISR, or of its decoding otherwise.
+   * With OS_GLITCH_FILTER_US, the packet is only decoded once the edge after
+   * its final one has arrived: the callback comes one edge late, the time
+   * returned here is still that of the final edge.
+   *
+   * @return uint32_t, the receive time [us]
    */
-  void loop(void);
+  uint32_t getPacketTime(void) const {
+    return this->packetTime;
+  }
 
-  /* */
-  void externalInterrupt(void);
+  /**
+   * @brief Counters of the decoding pipeline since start (or resetStats()).
+   *
+   * @return const OregonStats&, the counters
+   */
+  const OregonStats& getStats(void) {
+    this->stats.rejectedEarly = this->filter.rejected;
+#if OS_REID_SLOTS > 0
+    this->stats.reidentified = this->registry.reidentified;
+#endif
+    return this->stats;
+  }
+
+  /* Clears every counter in getStats() */
+  void resetStats(void);
+
+  /**
+   * @brief Sensors to decode (allowlist) or to ignore (denylist), keyed on
+   * (model, channel, id). Checked by the decoders as soon as these fields are
+   * received; empty by default, i.e. every sensor is decoded.
+   *
+   * @return SensorFilter&, the filter to fill
+   */
+  SensorFilter& getFilter(void) {
+    return this->filter;
+  }
+
+  /**
+   * @brief Sets the time within which a packet identical to one already
+   * delivered (same sensor, same payload) is dropped before the callback.
+   * Default OS_REPEAT_WINDOW_MS.
+   *
+   * @param ms the window [ms], 0 to deliver every repeat
+   */
+  void setRepeatWindow(uint32_t ms) {
+    this->repeatFilter.setWindow(ms);
+  }
+
+#if OS_SENSOR_SLOTS > 0
+  /**
+   * @brief Latest state of every sensor heard: last reading, last seen time,
+   * packet and checksum failure counts. Look up one sensor with find(), or
+   * iterate over all of them. Sensors are keyed on their stable id
+   * (Reading::sensorId), so a battery change does not start a new entry.
+   *
+   * @return const SensorTable&, the table (up to OS_SENSOR_SLOTS sensors)
+   */
+  const SensorTable& getSensors(void) const {
+    return this->sensors;
+  }
+#endif
 
   /**
    * @brief User-defined callback. Is invoked when a valid data package is received and parsed. The data is passed as argument for further processing.
@@ -80,48 +302,366 @@ class OregonBridge {
    */
   void registerCallback(osCallbackFunc callbackFunction);
 
- private:
   /**
-   * @brief Instances of decoder classes.   
+   * @brief User-defined callback, receiving the packet already parsed. Every
+   * field is decoded once per packet; the raw bytes are in Reading::data.
+   */
+  using osReadingCallbackFunc = void (*)(const Reading&);
+
+  /**
+   * @brief Registers user-defined callback.
+   * Callback prototype: void (*)(const Reading&)
+   * 
+   * @param callbackFunction the callback function.
    */
-  Device** devices = new Device*[DEVICES_NUM];
+  void registerCallback(osReadingCallbackFunc callbackFunction);
+
+ protected:
+  template <class... Ds>
+  friend class DeviceList;
+
+  /**
+   * @brief Takes the next pulse from the queue.
+   *
+   * @param p receives the pulse length [us]
+   * @return true if a pulse was available
+   */
+  bool popPulse(word& p);
+
+  /**
+   * @brief Handles a packet completed by the decoder of 'device': validates
+   * it, then invokes the user callback.
+   *
+   * @param device the device whose decoder is done
+   */
+  void packetReceived(Device* device);
+
+  /* Pipeline counters */
+  OregonStats stats = {};
+
+  /* Sensor filter shared by every decoder */
+  SensorFilter filter;
+
+  /* Receive time of the pulse being decoded, when given to feedPulse() */
+  void setPulseTime(uint32_t time) {
+    this->pulseTime = time;
+#ifndef OS_TIMESTAMP_ISR
+    this->pulseTimeSet = true;
+#endif
+  }
+
+ private:
+#ifdef OS_TIMESTAMP_ISR
+  /**
+    * @brief Edge timestamps queued by the interrupt, waiting for loop()
+    */
+  PulseRing<uint32_t, OS_PULSE_BUFFER_SIZE> pulses;
+
+  /* Timestamp of the edge starting the current pulse */
+  uint32_t lastEdge = 0;
 
-  /* Counter of used positions in 'devices' array */
-  uint8_t devicesCount = 0;
+#if OS_GLITCH_FILTER_US > 0
+  /* Edge ending the current pulse, held back until the next edge proves it is no glitch */
+  uint32_t pendingEdge = 0;
+  bool hasPendingEdge = false;
+#endif
 
+#else
   /**
-    * @brief Pulse length 
+    * @brief Pulse lengths queued by the interrupt, waiting for loop()
     */
-  volatile word pulse;
+  PulseRing<word, OS_PULSE_BUFFER_SIZE> pulses;
+
+  /* true once feedPulse() has given pulse times: micros() is not used then */
+  bool pulseTimeSet = false;
+#endif
+
+  /* Timestamp of the edge ending the pulse being decoded (with the glitch
+  filter, the edge before the last one queued) */
+  uint32_t pulseTime = 0;
+
+  /* Last packet of each sensor, to drop repeats */
+  RepeatFilter repeatFilter{OS_REPEAT_WINDOW_MS};
+
+#if OS_SENSOR_SLOTS > 0
+  /* Latest state of each sensor */
+  SensorTable sensors;
+#endif
+
+#if OS_REID_SLOTS > 0
+  /* Stable ids across battery changes */
+  SensorRegistry registry;
+#endif
+
+  /* Stable id of a sensor id, see Reading::sensorId */
+  byte sensorIdOf(byte protocol, word model, byte channel, byte id) const {
+#if OS_REID_SLOTS > 0
+    return this->registry.sensorIdOf(protocol, model, channel, id);
+#else
+    return id;
+#endif
+  }
+
+#ifdef OS_FRAME_RECOVERY
+  /* Failed frames waiting for another copy */
+  FrameRecovery recovery;
+#endif
+
+  /* Receive time of the last decoded packet */
+  uint32_t packetTime = 0;
+
+  /**
+   * @brief Staging slot: a copy of the last decoded packet, handed to the
+   * callback so it never sees a buffer the decoder is rewriting.
+   */
+  byte staged[OOK_DATA_SIZE];
+
+  /* Number of valid bytes in 'staged' */
+  byte stagedLength = 0;
 
   /**
    * @brief Pointer to user-provided callback function   
    */
-  osCallbackFunc usrCallbackfunc;
+  osCallbackFunc usrCallbackfunc = nullptr;
+
+  /**
+   * @brief Pointer to user-provided callback function, parsed packet version
+   */
+  osReadingCallbackFunc usrReadingCallbackfunc = nullptr;
 
   /**
-   * @brief Sends raw data to the decode class, and gets a parsed byte array.
+   * @brief Copies the decoded data into the staging slot and frees the decoder.
    * 
    * @param decoder DecodeOOK instance
-   * @return const byte*, decoded data
+   * @return const byte*, decoded data (staging slot)
    */
   const byte* dataToDecoder(class Device* decoder);
 
+#ifdef OS_BIT_REPAIR
+  /**
+   * @brief Repairs the staged packet at its weakest bit, see OS_BIT_REPAIR.
+   *
+   * @param device the device which decoded the packet
+   * @param weakBit the index of the weakest data bit, 0xff if unknown
+   * @param weakMargin distance of its pulse to the short/long threshold [us]
+   * @param runnerUpMargin the same for the next weakest bit [us]
+   * @return true if the staged packet was fixed
+   */
+  bool repairPacket(Device* device, byte weakBit, word weakMargin, word runnerUpMargin);
+#endif
+
+#ifdef OS_TIMESTAMP_ISR
+  /**
+   * @brief Turns one queued edge timestamp into a pulse width.
+   *
+   * @param t the edge timestamp [us]
+   * @param p receives the pulse length [us]
+   * @return true if a pulse was completed, false if the edge was held back
+   */
+  bool edgeToPulse(uint32_t t, word& p);
+#endif
+
   /**
  * @brief Utility function to log details aboout the incoming message.
  * 
  * @param device The device object generating the message
- * @param data The message data
+ * @param reading The parsed message
+ */
+  void printDetails(Device* device, const Reading& reading);
+};
+
+/**
+ * @brief Compile-time list of devices, stored inline (no heap). Feeding a
+ * pulse unrolls into one direct, inlinable call per device. Masks have one
+ * bit per device, in list order (byte or word, see DeviceMask).
+ */
+template <class... Ds>
+class DeviceList {
+ public:
+  template <class M>
+  M nextPulse(word, M, M, OregonBridgeCore&) { return 0; }
+  template <class M>
+  void resetDecoders(M) {}
+  template <class M>
+  void preambleSeen(M) {}
+  void setFilter(SensorFilter*) {}
+};
+
+template <class D, class... Ds>
+class DeviceList<D, Ds...> {
+ public:
+  /**
+   * @brief Feeds a pulse to the 'active' devices whose bit is set in 'route',
+   * and resets the other active decoders, unless they are idle already.
+   * Devices outside 'active' are skipped altogether.
+   * 
+   * @return M, bit mask of the decoders synchronized after the pulse
+   */
+  template <class M>
+  M nextPulse(word p, M route, M active, OregonBridgeCore& bridge) {
+    if (!active) return 0;
+    M sync = 0;
+    if (active & 1) {
+      if (route & 1) {
+        bridge.stats.decoderCalls++;
+        if (device.nextPulse(p)) bridge.packetReceived(&device);
+      } else {
+        device.getDecoder().rejectPulse();
+      }
+      sync = device.getDecoder().isSynchronized();
+    }
+    return sync | (next.nextPulse(p, (M)(route >> 1), (M)(active >> 1), bridge) << 1);
+  }
+
+  /* Resets the decoders whose bit is set in 'mask' */
+  template <class M>
+  void resetDecoders(M mask) {
+    if (mask & 1) device.getDecoder().resetDecoder();
+    next.resetDecoders((M)(mask >> 1));
+  }
+
+  /* Tells the decoders whose bit is set in 'mask' that their preamble was seen */
+  template <class M>
+  void preambleSeen(M mask) {
+    if (mask & 1) device.getDecoder().preambleSeen(D::Decoder::preambleMin);
+    if (mask >> 1) next.preambleSeen((M)(mask >> 1));
+  }
+
+  /* Hands the sensor filter to every decoder */
+  void setFilter(SensorFilter* filter) {
+    device.getDecoder().setFilter(filter);
+    next.setFilter(filter);
+  }
+
+ private:
+  D device;
+  DeviceList<Ds...> next;
+};
+
+/**
+ * @brief The bridge, receiving from the given set of devices.
+ * 
+ * @tparam Devices the device classes (extending Device) to decode
  */
-  void printDetails(Device* device, const byte* data);
+template <class... Devices>
+class OregonBridgeT : public OregonBridgeCore {
+ public:
+  OregonBridgeT() {
+    devices.setFilter(&this->filter);
+  }
+
+  /**
+   * @brief Main library function. Must be called each loop to check new data.
+   * Every pulse queued by the interrupt since the previous call is decoded.
+   */
+  void loop(void) {
+    word p;
+    while (popPulse(p)) {
+      // popping from the lock-free queue is the only hand-off with the interrupt
+#ifdef OS_ATOMIC_HANDOFF_ONLY
+      nextPulse(p);
+#else
+      noInterrupts();
+      nextPulse(p);
+      interrupts();
+#endif
+    }
+  }
+
+  /**
+   * @brief Decodes one pulse right away, bypassing the interrupt queue. Meant
+   * to replay recorded pulses (see PulseCapture.h); not to be mixed with
+   * externalInterrupt().
+   * 
+   * @param width the pulse length [us]
+   */
+  void feedPulse(word width) {
+    stats.pulses++;
+    nextPulse(width);
+  }
 
   /**
-   * @brief Add supported devices (and decoders) to the array.
+   * @brief Same, with the time of the edge ending the pulse, e.g. from a
+   * capture: packet times (and the repeat window) follow the given clock
+   * instead of micros().
    * 
-   * @tparam T The class of the device.
+   * @param width the pulse length [us]
+   * @param time the end of the pulse [us]
    */
-  template <class T>
-  void addDevice();
+  void feedPulse(word width, uint32_t time) {
+    setPulseTime(time);
+    feedPulse(width);
+  }
+
+ private:
+  typedef typename PulseRouter<Devices...>::Mask Mask;
+
+  /**
+   * @brief Instances of device classes, each holding its decoder.
+   */
+  DeviceList<Devices...> devices;
+
+#ifdef OS_PREAMBLE_LOCK
+  /* Bit of the device holding the preamble lock, 0 if none */
+  Mask lockOwner = 0;
+#endif
+
+#if OS_PREAMBLE_FRONTEND
+  /* Shared preamble stage: idle decoders are only woken up by their preamble */
+  PreambleFrontEnd<Devices...> frontEnd;
+
+  /* Decoders past their preamble, fed every pulse until done or reset */
+  Mask engaged = 0;
+#endif
+
+  /* Routes one pulse to the decoders, arbitrating the preamble lock */
+  void nextPulse(word p) {
+#if OS_PREAMBLE_FRONTEND
+    Mask fits;
+    Mask route = router.route(p, fits);
+    // a decoder busy with its packet ignores preamble-like runs in it
+    Mask started = frontEnd.step(fits) & ~engaged;
+    if (started) devices.preambleSeen(started);
+    Mask active = engaged | started | frontEnd.always;
+#else
+    Mask route = router.route(p);
+    Mask active = ~0;
+#endif
+#ifdef OS_PREAMBLE_LOCK
+    Mask sync = devices.nextPulse(p, route, lockOwner ? lockOwner : active, *this);
+    if (lockOwner) {
+      if (!(sync & lockOwner)) {
+        // done or reset: every decoder competes again
+        lockOwner = 0;
+        stats.lockReleases++;
+      }
+    } else if (sync) {
+      // the first synchronized decoder wins, the others restart from scratch
+      lockOwner = sync & -sync;
+      devices.resetDecoders((Mask)~lockOwner);
+      sync = lockOwner;
+      stats.lockAcquisitions++;
+    }
+#else
+    Mask sync = devices.nextPulse(p, route, active, *this);
+#endif
+#if OS_PREAMBLE_FRONTEND
+    engaged = sync;
+#else
+    (void)sync;
+#endif
+  }
+
+  /**
+   * @brief Pulse width classification, from the decoders' declared ranges.
+   */
+  PulseRouter<Devices...> router;
 };
 
+/**
+ * @brief The default bridge, receiving from every supported device.
+ * To save RAM and flash, instantiate OregonBridgeT with a subset instead.
+ */
+using OregonBridge = OregonBridgeT<OregonDevice_v1, OregonDevice_v2, OregonDevice_v3>;
+
 #endif
\ No newline at end of file
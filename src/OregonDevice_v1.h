@@ -41,11 +41,85 @@
 #include "DecodeOOK.h"
 #include "Device.h"
 
-class OregonDecoder_v1 : public DecodeOOK {
+class OregonDecoder_v1 final : public DecodeOOK<OregonDecoder_v1> {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+  // short/long split re-centred on the received pulses
+  AdaptiveThreshold<1465, 2930, 1900, 2700> timing;
+  // first pulse after the preamble (4200 us nominal), within +-12.5%: the
+  // clock of this transmission
+  word syncGap;
+#endif
+
  public:
-  virtual char decode(word width) {
+  // Accepted pulse widths: everything else resets the decoder
+  static const byte widthRangeCount = 1;
+  static WidthRange widthRange(byte /*i*/) {
+    return {900, 7000};
+  }
+
+  // Preamble for the shared front-end: at least 22 short pulses
+  static const byte preambleMin = 22;
+  static WidthRange preambleRange() {
+    return {900, 2299};
+  }
+
+  // Header fields (OregonDevice_v1 reports the same), all in byte 0
+  static byte idOf(const byte* data) {
+    return data[0] & 0x0f;
+  }
+
+  static byte channelOf(const byte* data) {
+    switch ((data[0] >> 4) & 0x0f) {
+      // Seems like v1 sensors have channel 1 reported as either 2 or 0
+      case 0x0:
+      case 0x2:
+        return 1;
+      case 0x4:
+        return 2;
+      case 0x8:
+        return 3;
+      default:
+        return 0;
+    }
+  }
+
+  /* Running 'sum of bytes' checksum: bytes 0-2, compared with byte 3. The
+  sensor filter is checked on byte 0, which holds channel and id */
+  bool gotByte(byte i) {
+    if (i == 0 && filter && !filter->check(0, channelOf(data), idOf(data))) return false;
+    if (i < 3)
+      sum += data[i];
+    else if (i == 3)
+      checksumOk = sum == data[3];
+    return true;
+  }
+
+  /* true if a sync pulse is within [min, max] us or, if adaptive, within the
+  same window scaled to the clock of the transmission (a single pulse measures
+  it: jitter must not lose what the nominal window accepts) */
+  bool isSync(word width, word min, word max) const {
+    if (min <= width && width <= max) return true;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    return (uint32_t)min * syncGap / 4200 <= width && width <= (uint32_t)max * syncGap / 4200;
+#else
+    return false;
+#endif
+  }
+
+  char decode(word width) {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    const word split = timing.split();
+#else
+    const word split = 2300;
+#endif
+#ifdef OS_BIT_REPAIR
+    if (state == OK || state == T0) noteMargin(width, split);
+#endif
     if (900 <= width && width <= 7000) {
-      byte w = width >= 2300;
+      byte w = width >= split;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+      if (state == OK || state == T0) timing.learn(width, w);
+#endif
 
       switch (state) {
         case UNKNOWN:
@@ -56,6 +130,10 @@ class OregonDecoder_v1 : public DecodeOOK {
             // Long pulse, start bit
             flip = 0;
             state = T1;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+            syncGap = width < 3675 ? 3675 : width > 4725 ? 4725 : width;
+            timing.begin((uint32_t)1465 * syncGap / 4200);
+#endif
           } else {
             // Reset decoder
             return -1;
@@ -86,7 +164,7 @@ class OregonDecoder_v1 : public DecodeOOK {
         case T1:
           // RF-on long pulse (approx 5.7 ms)
           //if (width < 4000) return -1;
-          if (5550 <= width && width <= 6000)
+          if (isSync(width, 5550, 6000))
             state = T2;
           else
             return -1;
@@ -97,10 +175,10 @@ class OregonDecoder_v1 : public DecodeOOK {
           be detected by measuring the pulse length.
           ~5.2ms: first bit 1
           ~6.6ms: first bit 0 */
-          if (4800 <= width && width <= 5400) {
+          if (isSync(width, 4800, 5400)) {
             flip = 1;
             state = T0;
-          } else if (6480 <= width && width <= 6880) {
+          } else if (isSync(width, 6480, 6880)) {
             gotBit(0);
           } else
             return -1;
@@ -116,15 +194,41 @@ class OregonDecoder_v1 : public DecodeOOK {
 };
 
 class OregonDevice_v1 : public Device {
+ public:
+  typedef OregonDecoder_v1 Decoder;
+
+ protected:
+  /* The decoder, stored inline */
+  OregonDecoder_v1 ookDecoder;
+
  public:
   OregonDevice_v1() {
-    this->dDecoder = new OregonDecoder_v1();
+    this->dDecoder = &ookDecoder;
+  }
+
+  /* Direct call to the concrete decoder: no virtual dispatch when invoked on
+  the device object itself, as the bridge does */
+  virtual bool nextPulse(word width) {
+    return ookDecoder.nextPulse(width);
+  }
+
+  Decoder& getDecoder() {
+    return ookDecoder;
   }
 
   virtual const char* getOsVersion(void) {
     return OS_PROTOCOL_V1;
   }
 
+  virtual uint8_t getProtocol(void) {
+    return OS_PROTOCOL_ID_V1;
+  }
+
+  /* Checksum verified by the decoder while the bytes arrived: O(1) */
+  virtual bool isPacketValid() {
+    return ookDecoder.isChecksumValid();
+  }
+
   /**
   * @brief Validate the checksum found at nibbles 6 and 7 with the value computed
   * by summing the preceding bytes.
@@ -143,7 +247,7 @@ class OregonDevice_v1 : public Device {
     bool success = sum_of_bytes == checksum;
 
 #ifdef OS_DEBUG
-    Serial.print("Checksum " + (success ? String("OK") : String("error")));
+    Serial.print(success ? "Checksum OK" : "Checksum error");
     Serial.print(". Expected: ");
     Serial.print(checksum, HEX);
     Serial.print(", computed: ");
@@ -153,6 +257,19 @@ class OregonDevice_v1 : public Device {
     return success;
   }
 
+  /* Decimal digits, a known channel code, -50.0 to +70.0 degrees */
+  bool isPlausible(const byte* data) {
+    if ((data[2] & 0x0f) > 9 || (data[1] >> 4) > 9 || (data[1] & 0x0f) > 9) return false;
+    if (!OregonDecoder_v1::channelOf(data)) return false;
+    int16_t temp = getTemperatureTenths(data);
+    return -500 <= temp && temp <= 700;
+  }
+
+  /* Every v1 sensor measures temperature */
+  bool hasTemperature(const byte* /*data*/) {
+    return true;
+  }
+
   /**
     * Compute and return the signed temperature value.
     * For OS v1, the temperature is contained in the 3rd to 6th nibbles. 
@@ -163,12 +280,12 @@ class OregonDevice_v1 : public Device {
     *    44 53 02 99
     *    xx bc sa xx
     *    Temperature (s) ab.c -> +25.3°C
+    * 
+    * The value is returned in tenths of degree (253), with integer math only.
     * */
-  float getTemperature(const byte* data) {
-    int sign = (data[2] & 0x20) < 1 ? 1 : -1;
-    float temp = (data[2] & 0x0f) * 10 + ((data[1] & 0xf0) >> 4) + (float)((data[1] & 0x0f) / 10.0);
-    float result = sign * temp;
-    return sign * temp;
+  int16_t getTemperatureTenths(const byte* data) {
+    int16_t temp = (data[2] & 0x0f) * 100 + ((data[1] & 0xf0) >> 4) * 10 + (data[1] & 0x0f);
+    return (data[2] & 0x20) ? -temp : temp;
   }
 
   /**
@@ -186,7 +303,7 @@ class OregonDevice_v1 : public Device {
   * For v1 sensors, the device id is the second nibble (first in order of reception)
   * */
   byte getId(const byte* data) {
-    return (data[0] & 0x0f);
+    return OregonDecoder_v1::idOf(data);
   }
 
   /**
@@ -194,21 +311,7 @@ class OregonDevice_v1 : public Device {
   * For v1 sensors, the channel is reported by the 1st nibble.
   */
   byte getChannel(const byte* data) {
-    byte channel = 0;
-    switch ((data[0] >> 4) & 0x0f) {
-      // Seems like v1 sensors have channel 1 reported as either 2 or 0
-      case 0x0:
-      case 0x2:
-        channel = 1;
-        break;
-      case 0x4:
-        channel = 2;
-        break;
-      case 0x8:
-        channel = 3;
-        break;
-    }
-    return channel;
+    return OregonDecoder_v1::channelOf(data);
   }
 
   // Cannot identify device model from data (no specific id)
@@ -41,27 +41,148 @@
 #include "DecodeOOK.h"
 #include "Device.h"
 
-class OregonDecoder_v2 : public DecodeOOK {
+class OregonDecoder_v2 final : public DecodeOOK<OregonDecoder_v2> {
+  // checksum position of the packet being received, once the model is known
+  byte sumPos;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+  // short/long split re-centred on the received pulses
+  AdaptiveThreshold<488, 976, 600, 850> timing;
+#endif
+
  public:
+  // Accepted pulse widths: data pulses and the trailing-off sync
+  static const byte widthRangeCount = 2;
+  static WidthRange widthRange(byte i) {
+    if (i == 0) return {200, 1199};
+    return {2500, 0xffff};
+  }
+
+  // Preamble for the shared front-end: at least 24 long pulses
+  static const byte preambleMin = 24;
+  static WidthRange preambleRange() {
+    return {700, 1199};
+  }
+
   // add one bit to the packet data buffer
-  virtual void gotBit(char value) {
-    // Add one bit only if the count is even as v2.1 messages are doubled
-    if (!(total_bits & 0x01)) {
-      data[pos] = (data[pos] >> 1) | (value ? 0x80 : 00);
-    }
-    total_bits++;
-    pos = total_bits >> 4;
-    if (pos >= sizeof data) {
+  void gotBit(char value) {
+#ifdef OS_BIT_REPAIR
+    // both bits of a pair rate the same data bit
+    noteBit(total_bits >> 1);
+#endif
+#ifdef OS_V2_PAIR_CHECK
+    // Odd bits are the inverted copy of the data bit just stored: a bit equal
+    // to it is an error, the frame is dropped right away
+    if ((total_bits & 0x01) && !value == !(shift & 0x80)) {
       resetDecoder();
       return;
     }
+#endif
+    // Add one bit only if the count is even as v2.1 messages are doubled
+    // (branch-free: even = 0 leaves the shift register unchanged)
+    byte even = !(total_bits & 0x01);
+    shift = (shift >> even) | (value && even ? 0x80 : 00);
+    // 16 bits received (8 data bits, doubled): store the whole byte
+    if (!(++total_bits & 0x0f)) {
+      data[pos] = shift;
+      bool keep = gotByte(pos);
+      pos = total_bits >> 4;
+      if (!keep || pos >= sizeof data) {
+        resetDecoder();
+        return;
+      }
+    }
     state = OK;
   }
 
-  virtual char decode(word width) {
+  /**
+   * @brief Position of the first checksum nibble for a model identifier
+   * (first two bytes, sync nibble 'A' included), or 0 if the model is not
+   * supported.
+   */
+  static byte checksumPos(word model) {
+    switch (model) {
+      case 0xea4c:  // THN132N
+      case 0x1a2d:  // THGR228N
+        return 16;
+      default:
+        return 0;
+    }
+  }
+
+  // Header fields (OregonDevice_v2 reports the same): model, channel, id
+  static word modelOf(const byte* data) {
+    return (data[0] << 8) | data[1];
+  }
+
+  // 0 for nibble 0 or above 8: headers reach here unchecked, from failed packets too
+  static byte channelOf(const byte* data) {
+    byte nibble = data[2] >> 4;
+    if (nibble == 0 || nibble > 8) return 0;
+    return 1 << (nibble - 1);
+  }
+
+  static byte idOf(const byte* data) {
+    return data[3];
+  }
+
+  /**
+   * @brief Running 'sum of nibbles' checksum, see OregonDevice_v2::validateChecksum().
+   * The checksum position is resolved as soon as the model identifier is in:
+   * packets of unsupported models are dropped there, not at the trailer.
+   * The sensor filter is checked once the id (byte 3) is in.
+   */
+  bool gotByte(byte i) {
+    byte b = data[i];
+    if (i < 2) {
+      sum += (b >> 4) + (b & 0x0f);
+      if (i == 1) sumPos = checksumPos(modelOf(data));
+      return i == 0 || sumPos;
+    }
+    if (i == 3 && filter && !filter->check(modelOf(data), channelOf(data), idOf(data))) return false;
+
+    byte last = sumPos >> 1;
+    if (i < last) {
+      sum += (b >> 4) + (b & 0x0f);
+    } else if (i == last) {
+      // odd position: the checksum starts with the low nibble of this byte
+      if (sumPos & 1)
+        sum += b >> 4;
+      else
+        checksumOk = (byte)(sum - 0x0a) == b;
+    } else if (i == last + 1 && (sumPos & 1)) {
+      checksumOk = (byte)(sum - 0x0a) == ((b >> 4) | ((data[last] & 0x0f) << 4));
+    }
+    return true;
+  }
+
+  // merge the data bits received so far into the last, incomplete byte
+  void flushTail() {
+    byte n = ((total_bits & 0x0f) + 1) >> 1;
+    if (n) data[pos] = (data[pos] >> n) | (shift & (0xff << (8 - n)));
+  }
+
+  // the calibration follows the packets that passed their checksum
+  void gotPacket() {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    timing.commit();
+#endif
+  }
+
+  char decode(word width) {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    const word split = timing.split();
+#else
+    const word split = 700;
+#endif
+#ifdef OS_BIT_REPAIR
+    if (state == OK || state == T0) noteMargin(width, split);
+#endif
     if (200 <= width && width < 1200) {
       // Pulse length: w=1 -> 'long' pulse, w=0 -> 'short' pulse
-      byte w = width >= 700;
+      byte w = width >= split;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+      if (state == OK || state == T0) timing.learn(width, w);
+#endif
 
       switch (state) {
         case UNKNOWN:
@@ -74,16 +195,17 @@ class OregonDecoder_v2 : public DecodeOOK {
             pulse, the preamble is considered finished, and we wait for the sync nibble - which
             is '1010', or hex 'A'. Long bits are used for the count. */
 
-          if (w != 0) {
-            // Long pulse
-            ++flip;
-          } else if (w == 0 && 24 <= flip) {
-            // Short pulse, start bit
-            flip = 0;
-            state = T0;
-          } else {
-            // Reset decoder
-            return -1;
+          switch (preamble(w, 1, 24)) {
+            case -1:
+              // Reset decoder
+              return -1;
+            case 1:
+              // Short pulse, start bit
+              flip = 0;
+              state = T0;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+              timing.begin();
+#endif
           }
           break;
         case OK:
@@ -117,15 +239,41 @@ class OregonDecoder_v2 : public DecodeOOK {
 };
 
 class OregonDevice_v2 : public Device {
+ public:
+  typedef OregonDecoder_v2 Decoder;
+
+ protected:
+  /* The decoder, stored inline */
+  OregonDecoder_v2 ookDecoder;
+
  public:
   OregonDevice_v2() {
-    this->dDecoder = new OregonDecoder_v2();
+    this->dDecoder = &ookDecoder;
+  }
+
+  /* Direct call to the concrete decoder: no virtual dispatch when invoked on
+  the device object itself, as the bridge does */
+  virtual bool nextPulse(word width) {
+    return ookDecoder.nextPulse(width);
+  }
+
+  Decoder& getDecoder() {
+    return ookDecoder;
   }
 
   virtual const char* getOsVersion(void) {
     return OS_PROTOCOL_V2;
   }
 
+  virtual uint8_t getProtocol(void) {
+    return OS_PROTOCOL_ID_V2;
+  }
+
+  /* Checksum verified by the decoder while the bytes arrived: O(1) */
+  virtual bool isPacketValid() {
+    return ookDecoder.isChecksumValid();
+  }
+
   /**
  * Validate the checksum found at 'checksum_nibble_idx' with the value computed
  * by summing the nibbles. No inversion in the nibbles themselves is required
@@ -166,7 +314,7 @@ class OregonDevice_v2 : public Device {
     bool success = sum_of_nibbles == checksum;
 
 #ifdef OS_DEBUG
-    Serial.print("Checksum " + (success ? String("OK") : String("error")));
+    Serial.print(success ? "Checksum OK" : "Checksum error");
     Serial.print(". Expected: ");
     Serial.print(checksum, HEX);
     Serial.print(", computed: ");
@@ -176,6 +324,21 @@ class OregonDevice_v2 : public Device {
     return success;
   }
 
+  /* Sync nibble, a known channel, decimal digits, -50.0 to +70.0 degrees */
+  bool isPlausible(const byte* data) {
+    byte channel = data[2] >> 4;
+    if ((data[0] & 0x0f) != 0x0a || (channel != 1 && channel != 2 && channel != 4)) return false;
+    if ((data[5] >> 4) > 9 || (data[5] & 0x0f) > 9 || (data[4] >> 4) > 9) return false;
+    if (getModelId(data) == 0x1a2d && ((data[7] & 0x0f) > 9 || (data[6] >> 4) > 9)) return false;
+    int16_t temp = getTemperatureTenths(data);
+    return -500 <= temp && temp <= 700;
+  }
+
+  /* THN132N and THGR228N both measure temperature */
+  bool hasTemperature(const byte* /*data*/) {
+    return true;
+  }
+
   /**
  * Compute and return the signed temperature value.
  * For OS v2.1, the temperature is contained in the 5th, 6th and 7th nibbles 
@@ -190,12 +353,17 @@ class OregonDevice_v2 : public Device {
  *    1A 2D 40 58 4C 08 88 82 53
  *    xx xx xx xx cx ab xs xx xx
  *    Temperature (s) ab.c -> -08.4°C
+ * 
+ * The value is returned in tenths of degree (-84), with integer math only.
  * */
-  float getTemperature(const byte* data) {
-    int sign = (data[6] & 0x8) ? -1 : 1;
-    float temp = ((data[5] & 0xF0) >> 4) * 10 + (data[5] & 0xF) + (float)(((data[4] & 0xF0) >> 4) / 10.0);
-    float result = sign * temp;
-    return sign * temp;
+  int16_t getTemperatureTenths(const byte* data) {
+    int16_t temp = ((data[5] & 0xF0) >> 4) * 100 + (data[5] & 0xF) * 10 + ((data[4] & 0xF0) >> 4);
+    return (data[6] & 0x8) ? -temp : temp;
+  }
+
+  /* Only THGR228N measures humidity */
+  bool hasHumidity(const byte* data) {
+    return getModelId(data) == 0x1a2d;
   }
 
   /**
@@ -232,7 +400,7 @@ class OregonDevice_v2 : public Device {
  * Return the sensor id.
  * */
   byte getId(const byte* data) {
-    return (data[3]);
+    return OregonDecoder_v2::idOf(data);
   }
 
   /**
@@ -242,8 +410,7 @@ class OregonDevice_v2 : public Device {
  * @return byte 
  */
   byte getChannel(const byte* data) {
-    byte channel;
-    return (1 << (((data[2] & 0xf0) >> 4) - 1));
+    return OregonDecoder_v2::channelOf(data);
   }
 
   /**
@@ -256,16 +423,11 @@ class OregonDevice_v2 : public Device {
 * @return uint8_t the position of the first checksum nibble
  */
   uint8_t getChecksumPos(const byte* data) {
-    switch ((data[0] << 8) | data[1]) {
-      case 0xea4c:  // THN132N
-      case 0x1a2d:  // THGR228N
-        return 16;
-      default:
+    uint8_t pos = OregonDecoder_v2::checksumPos(OregonDecoder_v2::modelOf(data));
 #ifdef OS_DEBUG
-        Serial.println("Known remote identifier not found - unable to validate checksum.");
+    if (!pos) Serial.println("Known remote identifier not found - unable to validate checksum.");
 #endif
-        return 0;
-    }
+    return pos;
 
     /*
     uint8_t checksum_idx = 0;
@@ -287,6 +449,11 @@ class OregonDevice_v2 : public Device {
     */
   }
 
+  // Model identifier: the first two bytes, sync nibble included
+  uint16_t getModelId(const byte* data) {
+    return OregonDecoder_v2::modelOf(data);
+  }
+
   // Detect type of sensor module
   const char* getRemoteModel(const byte* data) {
     switch ((data[0] << 8) | data[1]) {
@@ -0,0 +1,402 @@
+/**
+ * OregonDevice_v3.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file OregonDevice_v3.h
+ * @brief Decode messages from Oregon Scientific v3 devices (Manchester encoding)
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: OregonDevice_v3 added to OregonBridge library.
+ */
+
+#ifndef OregonDevice_v3_h
+#define OregonDevice_v3_h
+
+#include "DecodeOOK.h"
+#include "Device.h"
+
+/**
+ * @brief Oregon Scientific v3 decoder. Same pulse timing as v2.1 (1024 Hz
+ * Manchester), but every bit is sent once: the preamble of 24 '1' bits is a
+ * run of short pulses instead of long ones. Frames have no trailing sync,
+ * their length follows from the model.
+ */
+class OregonDecoder_v3 final : public DecodeOOK<OregonDecoder_v3> {
+  // checksum position and frame length [nibbles], once the model is known
+  byte sumPos, frameNibbles;
+  // first received (low) nibble of the checksum byte
+  byte low;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+  // short/long split re-centred on the received pulses
+  AdaptiveThreshold<488, 976, 600, 850> timing;
+#endif
+
+ public:
+  // Accepted pulse widths: data pulses only
+  static const byte widthRangeCount = 1;
+  static WidthRange widthRange(byte /*i*/) {
+    return {200, 1199};
+  }
+
+  // Preamble for the shared front-end: at least 32 short pulses
+  static const byte preambleMin = 32;
+  static WidthRange preambleRange() {
+    return {200, 699};
+  }
+
+  /**
+   * @brief Position of the first checksum nibble for a model identifier
+   * (first two bytes, sync nibble 'A' included), or 0 if the model is not
+   * supported.
+   */
+  static byte checksumPos(word model) {
+    switch (model) {
+      case 0xfa28:  // THGR810
+        return 16;
+      case 0xca48:  // THN802
+        return 13;
+      case 0xda78:  // UVN800
+        return 14;
+      case 0x1a89:  // WGR800
+        return 18;
+      case 0x2a19:  // PCR800
+        return 19;
+      default:
+        return 0;
+    }
+  }
+
+  /* Nibble 'n' of a frame, in reception order (low nibble of each byte first) */
+  static byte nibble(const byte* data, byte n) {
+    return n & 1 ? data[n >> 1] >> 4 : data[n >> 1] & 0x0f;
+  }
+
+  // Header fields (OregonDevice_v3 reports the same): model, channel, id
+  static word modelOf(const byte* data) {
+    return (data[0] << 8) | data[1];
+  }
+
+  static byte channelOf(const byte* data) {
+    return data[2] >> 4;
+  }
+
+  static byte idOf(const byte* data) {
+    return data[3];
+  }
+
+  /**
+   * @brief Checksum of a complete frame, computed from the buffer, see
+   * gotByte() for the running version.
+   */
+  static bool verify(const byte* data) {
+    byte pos = checksumPos(modelOf(data));
+    if (!pos) return false;
+
+    byte sum = 0;
+    for (byte n = 0; n < pos; n++) sum += nibble(data, n);
+    return (byte)(sum - 0x0a) == (nibble(data, pos) | nibble(data, pos + 1) << 4);
+  }
+
+  /**
+   * @brief Running 'sum of nibbles' checksum. The model is known at
+   * byte 1: unsupported models are dropped there, and the frame length is set.
+   * The sensor filter is checked once the id (byte 3) is in.
+   */
+  bool gotByte(byte i) {
+    byte b = data[i];
+    if (i < 2) {
+      sum += (b >> 4) + (b & 0x0f);
+      if (i == 0) return true;
+
+      sumPos = checksumPos(modelOf(data));
+      frameNibbles = sumPos + 2;
+      return sumPos;
+    }
+    if (i == 3 && filter && !filter->check(modelOf(data), channelOf(data), idOf(data))) return false;
+
+    gotNibble(i << 1, b & 0x0f);
+    gotNibble((i << 1) + 1, b >> 4);
+    return true;
+  }
+
+  // nibble 'n' (from byte 2 on) is in
+  void gotNibble(byte n, byte v) {
+    if (n < sumPos) {
+      sum += v;
+    } else if (n == sumPos) {
+      low = v;
+    } else if (n == sumPos + 1) {
+      checksumOk = (byte)(sum - 0x0a) == (low | v << 4);
+    }
+  }
+
+  // true once every nibble of the frame is in
+  bool frameComplete() const {
+    return pos >= 2 && total_bits >= frameNibbles << 2;
+  }
+
+  // the calibration follows the packets that passed their checksum
+  void gotPacket() {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    timing.commit();
+#endif
+  }
+
+  char decode(word width) {
+#ifdef OS_ADAPTIVE_THRESHOLDS
+    const word split = timing.split();
+#else
+    const word split = 700;
+#endif
+#ifdef OS_BIT_REPAIR
+    if (state == OK || state == T0) noteMargin(width, split);
+#endif
+    if (200 <= width && width < 1200) {
+      // Pulse length: w=1 -> 'long' pulse, w=0 -> 'short' pulse
+      byte w = width >= split;
+#ifdef OS_ADAPTIVE_THRESHOLDS
+      if (state == OK || state == T0) timing.learn(width, w);
+#endif
+
+      switch (state) {
+        case UNKNOWN:
+          /* The preamble is 24 '1' bits, i.e. short pulses only: at least 32
+          of them, then the first long pulse is the first bit of the sync
+          nibble 'A' (a '0', sent least significant bit first). */
+          switch (preamble(w, 0, 32)) {
+            case -1:
+              // Reset decoder
+              return -1;
+            case 1:
+#ifdef OS_ADAPTIVE_THRESHOLDS
+              timing.begin();
+#endif
+              flip = 1;
+              manchester(1);
+          }
+          break;
+        case OK:
+          if (w == 0) {
+            // Short pulse
+            state = T0;
+          } else {
+            // Long pulse
+            manchester(1);
+          }
+          break;
+        case T0:
+          if (w == 0) {
+            // Second short pulse
+            manchester(0);
+          } else {
+            // Reset decoder
+            return -1;
+          }
+          break;
+      }
+    } else {
+      return -1;
+    }
+    return frameComplete();
+  }
+};
+
+class OregonDevice_v3 : public Device {
+ public:
+  typedef OregonDecoder_v3 Decoder;
+
+ protected:
+  /* The decoder, stored inline */
+  OregonDecoder_v3 ookDecoder;
+
+  /* Decimal value of 'count' nibbles from 'first' on, least significant first */
+  static uint32_t digits(const byte* data, byte first, byte count) {
+    uint32_t value = 0;
+    for (byte n = first + count; n-- > first;) value = value * 10 + OregonDecoder_v3::nibble(data, n);
+    return value;
+  }
+
+  /* true if 'count' nibbles from 'first' on are decimal digits */
+  static bool isDecimal(const byte* data, byte first, byte count) {
+    for (byte n = first; n < first + count; n++)
+      if (OregonDecoder_v3::nibble(data, n) > 9) return false;
+    return true;
+  }
+
+ public:
+  OregonDevice_v3() {
+    this->dDecoder = &ookDecoder;
+  }
+
+  /* Direct call to the concrete decoder: no virtual dispatch when invoked on
+  the device object itself, as the bridge does */
+  virtual bool nextPulse(word width) {
+    return ookDecoder.nextPulse(width);
+  }
+
+  Decoder& getDecoder() {
+    return ookDecoder;
+  }
+
+  virtual const char* getOsVersion(void) {
+    return OS_PROTOCOL_V3;
+  }
+
+  virtual uint8_t getProtocol(void) {
+    return OS_PROTOCOL_ID_V3;
+  }
+
+  /* Checksum verified by the decoder while the bytes arrived: O(1) */
+  virtual bool isPacketValid() {
+    return ookDecoder.isChecksumValid();
+  }
+
+  /* Same sum of nibbles as v2.1, at a position depending on the model */
+  virtual bool validateChecksum(const byte* data) {
+    bool success = OregonDecoder_v3::verify(data);
+#ifdef OS_DEBUG
+    Serial.println(success ? "Checksum OK" : "Checksum error");
+#endif
+    return success;
+  }
+
+  /* Sync nibble, a channel, decimal digits in the fields of the model */
+  bool isPlausible(const byte* data) {
+    if ((data[0] & 0x0f) != 0x0a || !getChannel(data)) return false;
+    switch (getModelId(data)) {
+      case 0xfa28:  // THGR810
+        if (!isDecimal(data, 13, 2)) return false;
+        break;
+      case 0xca48:  // THN802
+        break;
+      case 0xda78:  // UVN800
+        return isDecimal(data, 9, 2);
+      case 0x1a89:  // WGR800
+        return isDecimal(data, 12, 6);
+      case 0x2a19:  // PCR800
+        return isDecimal(data, 9, 10);
+      default:
+        return false;
+    }
+    int16_t temp = getTemperatureTenths(data);
+    return isDecimal(data, 9, 3) && -500 <= temp && temp <= 700;
+  }
+
+  /* Only THGR810 and THN802 measure temperature */
+  bool hasTemperature(const byte* data) {
+    word model = getModelId(data);
+    return model == 0xfa28 || model == 0xca48;
+  }
+
+  /**
+   * Temperature of THGR810 and THN802, same layout as v2.1: nibbles 9 to 11
+   * (tenths first), sign in nibble 12. 0 for the other models.
+   */
+  int16_t getTemperatureTenths(const byte* data) {
+    if (!hasTemperature(data)) return 0;
+    int16_t temp = digits(data, 9, 3);
+    return (data[6] & 0x8) ? -temp : temp;
+  }
+
+  /* Only THGR810 measures humidity */
+  bool hasHumidity(const byte* data) {
+    return getModelId(data) == 0xfa28;
+  }
+
+  /* Humidity of THGR810, nibbles 13 and 14 (units first); 0 for the other models */
+  byte getHumidity(const byte* data) {
+    if (!hasHumidity(data)) return 0;
+    return digits(data, 13, 2);
+  }
+
+  /* UV index of UVN800, nibbles 9 and 10 (units first) */
+  byte getUvIndex(const byte* data) {
+    return digits(data, 9, 2);
+  }
+
+  /* Wind direction of WGR800, in 16 sectors of 22.5 degrees (0: north) */
+  byte getWindDirection(const byte* data) {
+    return OregonDecoder_v3::nibble(data, 9);
+  }
+
+  /* Wind gust and average speed of WGR800 [tenths of m/s] */
+  word getWindGust(const byte* data) {
+    return digits(data, 12, 3);
+  }
+
+  word getWindAverage(const byte* data) {
+    return digits(data, 15, 3);
+  }
+
+  /* Rain rate [hundredths of inch per hour] and total [thousandths of inch] of PCR800 */
+  word getRainRate(const byte* data) {
+    return digits(data, 9, 4);
+  }
+
+  uint32_t getRainTotal(const byte* data) {
+    return digits(data, 13, 6);
+  }
+
+  /* Battery flag in nibble 8, as in v2.1 */
+  bool getBattery(const byte* data) {
+    return !(data[4] & 0x4);
+  }
+
+  byte getId(const byte* data) {
+    return OregonDecoder_v3::idOf(data);
+  }
+
+  /* Channel number, sent as is (1 to 15) */
+  byte getChannel(const byte* data) {
+    return OregonDecoder_v3::channelOf(data);
+  }
+
+  // Model identifier: the first two bytes, sync nibble included
+  uint16_t getModelId(const byte* data) {
+    return OregonDecoder_v3::modelOf(data);
+  }
+
+  // Detect type of sensor module
+  const char* getRemoteModel(const byte* data) {
+    switch (getModelId(data)) {
+      case 0xfa28:
+        return "THGR810";
+      case 0xca48:
+        return "THN802";
+      case 0xda78:
+        return "UVN800";
+      case 0x1a89:
+        return "WGR800";
+      case 0x2a19:
+        return "PCR800";
+      default:
+        return "UNKNOWN";
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * PreambleFrontEnd.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file PreambleFrontEnd.h
+ * @brief Recognizes the preambles of every decoder in a single pass over the
+ * pulse stream, and wakes up the matching decoder only.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: PreambleFrontEnd added to OregonBridge library.
+ */
+
+#ifndef PreambleFrontEnd_h
+#define PreambleFrontEnd_h
+
+#include "Arduino.h"
+#include "PulseRouter.h"
+
+/* Number of bits needed to hold N */
+template <unsigned N>
+struct BitLength {
+  static const byte value = 1 + BitLength<(N >> 1)>::value;
+};
+
+template <>
+struct BitLength<0> {
+  static const byte value = 0;
+};
+
+/**
+ * @brief Shared preamble stage of the decoders. Each decoder declares its
+ * preamble as a run of at least 'preambleMin' pulses within 'preambleRange()';
+ * the PulseRouter gives, with the same lookup that routes a pulse, the set
+ * of preambles the pulse fits. The front-end follows the runs of all the
+ * preambles at once, with bit-sliced counters: bit i of plane k is bit k of
+ * the i-th decoder's counter, so one step is the same few mask operations per
+ * plane whatever the number of decoders, with no branch. When a run long
+ * enough ends, its decoder is handed the pulse ending it (its start bit), and
+ * decodes the payload on its own.
+ *
+ * Idle decoders are not called at all: only the decoders past their preamble,
+ * and those declaring no preamble ('always'), get the pulses.
+ *
+ * @tparam Devices the device classes, each declaring its Decoder type
+ */
+template <class... Devices>
+class PreambleFrontEnd {
+ public:
+  typedef typename DeviceMask<sizeof...(Devices)>::type Mask;
+
+  PreambleFrontEnd() {
+    byte minimum[sizeof...(Devices)];
+    WidthRanges<Devices...>::preambleMinimums(minimum);
+    for (byte i = 0; i < sizeof...(Devices); i++)
+      for (byte k = 0; k < planes; k++)
+        if (minimum[i] && ((minimum[i] - 1) >> k & 1)) first[k] |= (Mask)1 << i;
+    always = WidthRanges<Devices...>::alwaysMask(0);
+  }
+
+  /**
+   * @brief Follows the preamble runs with one more pulse.
+   *
+   * @param fits the preambles the pulse fits, see PulseRouter::route()
+   * @return Mask, the decoders whose preamble the pulse completes: a run of
+   * at least 'preambleMin' pulses, ended by this one
+   */
+  Mask step(Mask fits) {
+    Mask done = reached & ~fits;
+    // a run starting loads 'preambleMin - 1', a run going on counts down to 0
+    Mask starting = fits & ~runs;
+    Mask borrow = fits & runs & ~reached;
+    Mask nonzero = 0;
+    for (byte k = 0; k < planes; k++) {
+      Mask c = count[k];
+      Mask b = borrow & ~c;
+      c ^= borrow;
+      borrow = b;
+      c = (c & ~starting) | (first[k] & starting);
+      count[k] = c;
+      nonzero |= c;
+    }
+    reached = fits & ~nonzero;
+    runs = fits;
+    return done;
+  }
+
+  /* Decoders declaring no preamble: they get every pulse */
+  Mask always;
+
+ private:
+  /* Bit planes of the counters: enough for the longest preamble */
+  static const byte longest = WidthRanges<Devices...>::longestPreamble;
+  static const byte planes = longest > 1 ? BitLength<longest - 1>::value : 1;
+
+  /* Preambles whose run goes on with the last pulse, and long enough already */
+  Mask runs = 0;
+  Mask reached = 0;
+
+  /* Pulses left before each run is long enough, and their initial value */
+  Mask count[planes] = {};
+  Mask first[planes] = {};
+};
+
+#endif
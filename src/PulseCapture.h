@@ -0,0 +1,138 @@
+/**
+ * PulseCapture.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file PulseCapture.h
+ * @brief Compact binary format to record raw receiver pulses and replay them.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: PulseCapture added to OregonBridge library.
+ */
+
+#ifndef PulseCapture_h
+#define PulseCapture_h
+
+#include "Arduino.h"
+
+/**
+ * Capture format:
+ *
+ *    'O' 'B' 'P' 'C'   magic
+ *    0x01              format version
+ *    0x00              flags, reserved
+ *    0x00 0x00         reserved
+ *    varint...         one per pulse, until the end of the capture
+ *
+ * Each pulse is the time between two consecutive edges [us], stored as an
+ * unsigned LEB128 varint: 7 bits per byte, least significant group first, bit
+ * 7 set on every byte but the last. Oregon pulses (200-7000 us) take 2 bytes.
+ */
+#define PULSE_CAPTURE_VERSION 1
+#define PULSE_CAPTURE_HEADER_SIZE 8
+
+/**
+ * @brief Writes a capture to any Print (Serial, a File, a host buffer...).
+ */
+class PulseCaptureWriter {
+ public:
+  PulseCaptureWriter(Print& out) : out(out) {}
+
+  /* Writes the header: must be called once, before any pulse */
+  void begin(void) {
+    const byte header[PULSE_CAPTURE_HEADER_SIZE] = {'O', 'B', 'P', 'C', PULSE_CAPTURE_VERSION, 0, 0, 0};
+    out.write(header, sizeof header);
+  }
+
+  /**
+   * @brief Appends one pulse.
+   *
+   * @param width the pulse length [us]
+   */
+  void write(uint32_t width) {
+    byte buf[5];
+    byte n = 0;
+    while (width >= 0x80) {
+      buf[n++] = (width & 0x7f) | 0x80;
+      width >>= 7;
+    }
+    buf[n++] = width;
+    out.write(buf, n);
+  }
+
+ private:
+  Print& out;
+};
+
+/**
+ * @brief Reads a capture held in memory.
+ */
+class PulseCaptureReader {
+ public:
+  PulseCaptureReader(const byte* data, uint32_t size) : data(data), size(size) {}
+
+  /**
+   * @brief Checks the header and moves to the first pulse.
+   *
+   * @return true if the header is valid and the version supported
+   */
+  bool begin(void) {
+    if (size < PULSE_CAPTURE_HEADER_SIZE) return false;
+    if (data[0] != 'O' || data[1] != 'B' || data[2] != 'P' || data[3] != 'C') return false;
+    if (data[4] != PULSE_CAPTURE_VERSION) return false;
+    pos = PULSE_CAPTURE_HEADER_SIZE;
+    return true;
+  }
+
+  /**
+   * @brief Reads the next pulse.
+   *
+   * @param width receives the pulse length [us]
+   * @return true if a pulse was read, false at the end of the capture (or
+   * on a truncated varint)
+   */
+  bool next(uint32_t& width) {
+    uint32_t value = 0;
+    byte shift = 0;
+    while (pos < size && shift < 35) {
+      byte b = data[pos++];
+      value |= (uint32_t)(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        width = value;
+        return true;
+      }
+      shift += 7;
+    }
+    return false;
+  }
+
+ private:
+  const byte* data;
+  uint32_t size;
+  uint32_t pos = 0;
+};
+
+#endif
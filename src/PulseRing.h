@@ -0,0 +1,110 @@
+/**
+ * PulseRing.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file PulseRing.h
+ * @brief Lock-free ring buffer handing pulses from the receiver interrupt to loop().
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: PulseRing added to OregonBridge library.
+ */
+
+#ifndef PulseRing_h
+#define PulseRing_h
+
+#include "Arduino.h"
+
+/**
+ * @brief Fixed-capacity single-producer/single-consumer ring buffer.
+ * The receiver interrupt is the only producer (push), loop() the only
+ * consumer (pop). Head and tail are free-running single bytes, so every
+ * index access is atomic even on 8-bit AVR and neither side needs to
+ * disable interrupts. The slot is written before the head is published,
+ * so the consumer never reads a half-written element.
+ *
+ * @tparam T the element type (e.g. pulse width)
+ * @tparam N the capacity, a power of two between 2 and 128
+ */
+template <class T, uint8_t N>
+class PulseRing {
+  static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0,
+                "PulseRing capacity must be a power of two between 2 and 128");
+
+ public:
+  /**
+   * @brief Append one element. Producer side, to be called from the ISR only.
+   *
+   * @param value the element to be queued
+   * @return true if queued, false if the ring was full and the value dropped
+   */
+  bool push(T value) {
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) >= N) {
+      if (overflows != 0xffff) overflows++;
+      return false;
+    }
+    buffer[h & (N - 1)] = value;
+    head = h + 1;
+    return true;
+  }
+
+  /**
+   * @brief Remove the oldest element. Consumer side, to be called from loop() only.
+   *
+   * @param value receives the element, if any
+   * @return true if an element was available
+   */
+  bool pop(T& value) {
+    uint8_t t = tail;
+    if (t == head) return false;
+    value = buffer[t & (N - 1)];
+    tail = t + 1;
+    return true;
+  }
+
+  /* Number of elements waiting to be consumed */
+  uint8_t available(void) const {
+    return (uint8_t)(head - tail);
+  }
+
+  /**
+   * @brief Number of elements dropped because the consumer fell behind
+   * (saturates at 0xffff). The counter is written by the producer: on 8-bit
+   * targets read it with interrupts disabled.
+   */
+  uint16_t getOverflowCount(void) const {
+    return overflows;
+  }
+
+ private:
+  volatile T buffer[N];
+  volatile uint8_t head = 0;
+  volatile uint8_t tail = 0;
+  volatile uint16_t overflows = 0;
+};
+
+#endif
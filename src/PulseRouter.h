@@ -0,0 +1,215 @@
+/**
+ * PulseRouter.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file PulseRouter.h
+ * @brief Routes each pulse only to the decoders that can accept its width.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: PulseRouter added to OregonBridge library.
+ * - Oct. 2026: preamble classes and up to 16 devices.
+ */
+
+#ifndef PulseRouter_h
+#define PulseRouter_h
+
+#include "Arduino.h"
+#include "DecodeOOK.h"
+
+/**
+ * @brief Bit mask with one bit per device, in list order: a byte for up to 8
+ * devices, a word for up to 16.
+ */
+template <byte N, bool Small = (N <= 8)>
+struct DeviceMask {
+  typedef byte type;
+};
+
+template <byte N>
+struct DeviceMask<N, false> {
+  typedef word type;
+};
+
+/**
+ * @brief Compile-time walk over the WidthRange declarations of the decoders
+ * of a device list (Device::Decoder::widthRange, preambleRange).
+ */
+template <class... Ds>
+struct WidthRanges {
+  static const byte count = 0;
+  static const byte longestPreamble = 0;
+  static void bounds(word*, byte&) {}
+  static word mask(word, byte) { return 0; }
+  static word preambleMask(word, byte) { return 0; }
+  static word alwaysMask(byte) { return 0; }
+  static void preambleMinimums(byte*) {}
+};
+
+template <class D, class... Ds>
+struct WidthRanges<D, Ds...> {
+  typedef typename D::Decoder Decoder;
+
+  /* Total number of declared ranges, preambles included */
+  static const byte count = Decoder::widthRangeCount + 1 + WidthRanges<Ds...>::count;
+
+  /* Largest 'preambleMin' */
+  static const byte longestPreamble = Decoder::preambleMin > WidthRanges<Ds...>::longestPreamble
+                                          ? Decoder::preambleMin
+                                          : WidthRanges<Ds...>::longestPreamble;
+
+  /* Appends the first width of every range, and the first one after it */
+  static void bounds(word* out, byte& n) {
+    for (byte i = 0; i < Decoder::widthRangeCount; i++) add(Decoder::widthRange(i), out, n);
+    if (Decoder::preambleMin) add(Decoder::preambleRange(), out, n);
+    WidthRanges<Ds...>::bounds(out, n);
+  }
+
+  static void add(WidthRange r, word* out, byte& n) {
+    out[n++] = r.min;
+    if (r.max != 0xffff) out[n++] = r.max + 1;
+  }
+
+  /* Bit mask of the decoders accepting 'width', first decoder in 'bit' */
+  static word mask(word width, byte bit) {
+    word m = 0;
+    for (byte i = 0; i < Decoder::widthRangeCount; i++) {
+      WidthRange r = Decoder::widthRange(i);
+      if (r.min <= width && width <= r.max) m = 1 << bit;
+    }
+    return m | WidthRanges<Ds...>::mask(width, bit + 1);
+  }
+
+  /* Bit mask of the decoders whose preamble pulses include 'width' */
+  static word preambleMask(word width, byte bit) {
+    WidthRange r = Decoder::preambleRange();
+    word m = Decoder::preambleMin && r.min <= width && width <= r.max ? 1 << bit : 0;
+    return m | WidthRanges<Ds...>::preambleMask(width, bit + 1);
+  }
+
+  /* Bit mask of the decoders declaring no preamble */
+  static word alwaysMask(byte bit) {
+    return (Decoder::preambleMin ? 0 : 1 << bit) | WidthRanges<Ds...>::alwaysMask(bit + 1);
+  }
+
+  /* Least number of preamble pulses of each decoder */
+  static void preambleMinimums(byte* out) {
+    *out = Decoder::preambleMin;
+    WidthRanges<Ds...>::preambleMinimums(out + 1);
+  }
+};
+
+/**
+ * @brief Classifies a pulse width into one of the intervals delimited by the
+ * declared WidthRange bounds, and returns the bit mask (one bit per device,
+ * in list order) of the decoders that may accept it, and of the preambles
+ * it may belong to. The tables are built once from the compile-time
+ * declarations; a lookup is a binary search over the bounds.
+ *
+ * @tparam Devices the device classes, each declaring its Decoder type
+ */
+template <class... Devices>
+class PulseRouter {
+  static_assert(sizeof...(Devices) <= 16, "PulseRouter handles up to 16 devices");
+
+ public:
+  typedef typename DeviceMask<sizeof...(Devices)>::type Mask;
+
+  PulseRouter() {
+    WidthRanges<Devices...>::bounds(bounds, count);
+
+    // sort the bounds and drop duplicates
+    for (byte i = 1; i < count; i++)
+      for (byte j = i; j > 0 && bounds[j - 1] > bounds[j]; j--) {
+        word t = bounds[j];
+        bounds[j] = bounds[j - 1];
+        bounds[j - 1] = t;
+      }
+    byte n = 0;
+    for (byte i = 0; i < count; i++)
+      if (n == 0 || bounds[n - 1] != bounds[i]) bounds[n++] = bounds[i];
+    count = n;
+
+    // interval c spans [bounds[c - 1], bounds[c]): any width in it is representative
+    for (byte c = 0; c <= count; c++) {
+      word w = c ? bounds[c - 1] : 0;
+      masks[c] = WidthRanges<Devices...>::mask(w, 0);
+      preambles[c] = WidthRanges<Devices...>::preambleMask(w, 0);
+    }
+  }
+
+  /**
+   * @brief Get the decoders that may accept a pulse.
+   *
+   * @param width the pulse length [us]
+   * @return Mask, bit i set if the i-th device's decoder accepts 'width'
+   */
+  Mask route(word width) const {
+    return masks[classify(width)];
+  }
+
+  /**
+   * @brief Same, also giving the preambles the pulse may belong to.
+   *
+   * @param width the pulse length [us]
+   * @param preamble receives bit i set if 'width' fits the preamble of the
+   * i-th device's decoder
+   * @return Mask, bit i set if the i-th device's decoder accepts 'width'
+   */
+  Mask route(word width, Mask& preamble) const {
+    byte c = classify(width);
+    preamble = preambles[c];
+    return masks[c];
+  }
+
+ private:
+  static const byte maxBounds = 2 * WidthRanges<Devices...>::count;
+
+  /* Sorted interval bounds */
+  word bounds[maxBounds];
+
+  /* Decoder and preamble masks of each interval, one more than the bounds */
+  Mask masks[maxBounds + 1];
+  Mask preambles[maxBounds + 1];
+
+  /* Number of used positions in 'bounds' */
+  byte count = 0;
+
+  /* Interval of 'width': the number of bounds not above it */
+  byte classify(word width) const {
+    byte lo = 0, hi = count;
+    while (lo < hi) {
+      byte mid = (lo + hi) >> 1;
+      if (width >= bounds[mid])
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * Reading.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file Reading.h
+ * @brief Decoded values of one valid packet.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: Reading added to OregonBridge library.
+ */
+
+#ifndef Reading_h
+#define Reading_h
+
+#include "Arduino.h"
+
+/**
+ * @brief Every field of a valid packet, parsed once by Device::read() and
+ * handed to the callback. Plain data: it can be copied and stored freely,
+ * except for 'data', which points to the bridge staging slot and is only
+ * valid during the callback.
+ */
+struct Reading {
+  /* Receive time [us], see OregonBridgeCore::getPacketTime() */
+  uint32_t time;
+
+  /* Model name, e.g. "THGR228N" (static string) */
+  const char* modelName;
+
+  /* Raw packet bytes, for debugging (valid during the callback only) */
+  const byte* data;
+
+  /* Model identifier (first two bytes for v2.1 and v3), 0 if the protocol has none */
+  uint16_t model;
+
+  /* Temperature [tenths of degree Celsius], e.g. -84 for -8.4°C; 0 if the
+  model has none, see hasTemperature */
+  int16_t temperature;
+
+  /* Protocol, OS_PROTOCOL_ID_V1, OS_PROTOCOL_ID_V2 or OS_PROTOCOL_ID_V3 */
+  uint8_t protocol;
+
+  /* Sensor id, as sent: a new random one after each battery change */
+  uint8_t id;
+
+  /* Stable sensor id: the id first heard from this model and channel, kept
+  when the sensor comes back with a new one (see OS_REID_SLOTS); 'id' otherwise */
+  uint8_t sensorId;
+
+  /* Channel the sensor is operating on */
+  uint8_t channel;
+
+  /* Humidity [percentage]; 0 if the model has none, see hasHumidity */
+  uint8_t humidity;
+
+  /* true: good battery level, false: low battery level */
+  bool battery;
+
+  /* Number of bytes in 'data' */
+  uint8_t length;
+
+  /* true if the model measures temperature (not UV, wind or rain sensors) */
+  bool hasTemperature;
+
+  /* true if the model measures humidity (THGR228N, THGR810): a humidity of 0
+  is then a real value */
+  bool hasHumidity;
+};
+
+/**
+ * @brief Render a value in tenths (e.g. Reading::temperature) as a decimal
+ * string such as "-12.3", without floating point. Like snprintf, the output
+ * is truncated to fit and always NUL-terminated when size > 0.
+ * 
+ * @param value the value [tenths], e.g. -123
+ * @param buf the destination buffer
+ * @param size size of 'buf' [bytes]; 8 always fits
+ * @return byte, the length of the full string, NUL excluded
+ */
+inline byte formatTenths(int16_t value, char* buf, byte size) {
+  char tmp[7];  // worst case "-3276.8", reversed
+  byte len = 0;
+  uint16_t v = value < 0 ? (uint16_t)(-(int32_t)value) : (uint16_t)value;
+
+  tmp[len++] = '0' + v % 10;
+  tmp[len++] = '.';
+  v /= 10;
+  do {
+    tmp[len++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  if (value < 0) tmp[len++] = '-';
+
+  if (size > 0) {
+    byte n = len < size ? len : size - 1;
+    for (byte i = 0; i < n; i++) buf[i] = tmp[len - 1 - i];
+    buf[n] = '\0';
+  }
+  return len;
+}
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * ReadingFormat.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file ReadingFormat.h
+ * @brief Serializes a Reading as JSON, InfluxDB line protocol or CSV,
+ * without heap allocation.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: ReadingFormat added to OregonBridge library.
+ */
+
+#ifndef ReadingFormat_h
+#define ReadingFormat_h
+
+#include "Arduino.h"
+#include "Device.h"
+#include "Reading.h"
+
+/* Measurement name of the InfluxDB line protocol output */
+#ifndef OS_LINE_MEASUREMENT
+#define OS_LINE_MEASUREMENT "oregon"
+#endif
+
+/**
+ * @brief Output formats of formatReading() and printReading(). Every format
+ * has the same fields: model, protocol, channel, id, sensor_id, battery_ok,
+ * temperature [degree Celsius] and humidity [%], each left out (CSV: empty)
+ * when the model has none. Reading::time (micros()) is not written: timestamp on arrival.
+ *
+ * - READING_JSON: one object, e.g.
+ *   {"model":"THGR228N","protocol":"v2.1","channel":1,"id":91,"sensor_id":91,
+ *   "battery_ok":true,"temperature":21.5,"humidity":74}
+ * - READING_LINE_PROTOCOL: one line, model, protocol, channel and sensor_id
+ *   as tags, e.g.
+ *   oregon,model=THGR228N,protocol=v2.1,channel=1,sensor_id=91 id=91i,battery_ok=true,temperature=21.5,humidity=74i
+ * - READING_CSV: one line in the column order of readingCsvHeader(), e.g.
+ *   THGR228N,v2.1,1,91,91,1,21.5,74
+ *
+ * Lines (line protocol and CSV) end with '\n', JSON objects do not.
+ */
+enum ReadingFormat { READING_JSON,
+                     READING_LINE_PROTOCOL,
+                     READING_CSV };
+
+/* Header line of the CSV format */
+inline const char* readingCsvHeader() {
+  return "model,protocol,channel,id,sensor_id,battery_ok,temperature,humidity\n";
+}
+
+/**
+ * @brief Destination of the serializers: a buffer, filled like snprintf, or a
+ * Print. Counts every character either way.
+ */
+class ReadingSink {
+ public:
+  ReadingSink(char* buf, size_t size) : buf(buf), size(size) {}
+  ReadingSink(Print& out) : out(&out) {}
+
+  void write(const char* s, size_t n) {
+    if (this->out) {
+      this->out->write((const uint8_t*)s, n);
+    } else {
+      for (size_t i = 0; i < n && this->length + i + 1 < this->size; i++) this->buf[this->length + i] = s[i];
+    }
+    this->length += n;
+  }
+
+  void write(const char* s) { write(s, strlen(s)); }
+  void write(char c) { write(&c, 1); }
+
+  void number(uint16_t value) {
+    char tmp[5];
+    byte n = 0;
+    do {
+      tmp[sizeof tmp - ++n] = '0' + value % 10;
+      value /= 10;
+    } while (value);
+    write(tmp + sizeof tmp - n, n);
+  }
+
+  void tenths(int16_t value) {
+    char tmp[8];
+    write(tmp, formatTenths(value, tmp, sizeof tmp));
+  }
+
+  /* Writes 's', with a backslash before every character of 'special' */
+  void escaped(const char* s, const char* special) {
+    for (; *s; s++) {
+      if (strchr(special, *s)) write('\\');
+      write(*s);
+    }
+  }
+
+  /* NUL-terminates the buffer; returns the full length, NUL excluded */
+  size_t finish() {
+    if (!this->out && this->size) this->buf[this->length < this->size ? this->length : this->size - 1] = '\0';
+    return this->length;
+  }
+
+ private:
+  char* buf = nullptr;
+  size_t size = 0;
+  Print* out = nullptr;
+  size_t length = 0;
+};
+
+/* Writes 'reading' to 'sink' in 'format', see ReadingFormat */
+inline void writeReading(const Reading& reading, ReadingFormat format, ReadingSink& sink) {
+  const char* protocol = protocolName(reading.protocol);
+  switch (format) {
+    case READING_JSON:
+      sink.write("{\"model\":\"");
+      sink.escaped(reading.modelName, "\"\\");
+      sink.write("\",\"protocol\":\"");
+      sink.write(protocol);
+      sink.write("\",\"channel\":");
+      sink.number(reading.channel);
+      sink.write(",\"id\":");
+      sink.number(reading.id);
+      sink.write(",\"sensor_id\":");
+      sink.number(reading.sensorId);
+      sink.write(reading.battery ? ",\"battery_ok\":true" : ",\"battery_ok\":false");
+      if (reading.hasTemperature) {
+        sink.write(",\"temperature\":");
+        sink.tenths(reading.temperature);
+      }
+      if (reading.hasHumidity) {
+        sink.write(",\"humidity\":");
+        sink.number(reading.humidity);
+      }
+      sink.write('}');
+      break;
+
+    case READING_LINE_PROTOCOL:
+      sink.write(OS_LINE_MEASUREMENT ",model=");
+      sink.escaped(reading.modelName, " ,=\\");
+      sink.write(",protocol=");
+      sink.write(protocol);
+      sink.write(",channel=");
+      sink.number(reading.channel);
+      sink.write(",sensor_id=");
+      sink.number(reading.sensorId);
+      sink.write(" id=");
+      sink.number(reading.id);
+      sink.write(reading.battery ? "i,battery_ok=true" : "i,battery_ok=false");
+      if (reading.hasTemperature) {
+        sink.write(",temperature=");
+        sink.tenths(reading.temperature);
+      }
+      if (reading.hasHumidity) {
+        sink.write(",humidity=");
+        sink.number(reading.humidity);
+        sink.write('i');
+      }
+      sink.write('\n');
+      break;
+
+    case READING_CSV:
+      // model names hold no comma or quote
+      sink.write(reading.modelName);
+      sink.write(',');
+      sink.write(protocol);
+      sink.write(',');
+      sink.number(reading.channel);
+      sink.write(',');
+      sink.number(reading.id);
+      sink.write(',');
+      sink.number(reading.sensorId);
+      sink.write(reading.battery ? ",1," : ",0,");
+      if (reading.hasTemperature) sink.tenths(reading.temperature);
+      sink.write(',');
+      if (reading.hasHumidity) sink.number(reading.humidity);
+      sink.write('\n');
+      break;
+  }
+}
+
+/**
+ * @brief Serializes a reading into a buffer. Like snprintf, the output is
+ * truncated to fit and always NUL-terminated when size > 0; with a null
+ * buffer and size 0 it only measures.
+ *
+ * @param reading the reading
+ * @param format READING_JSON, READING_LINE_PROTOCOL or READING_CSV
+ * @param buf the destination buffer
+ * @param size size of 'buf' [bytes]
+ * @return size_t, the length of the full output, NUL excluded: the output
+ * fits if it is less than 'size'
+ */
+inline size_t formatReading(const Reading& reading, ReadingFormat format, char* buf, size_t size) {
+  ReadingSink sink(buf, size);
+  writeReading(reading, format, sink);
+  return sink.finish();
+}
+
+/**
+ * @brief Serializes a reading to a Print (Serial, a network client...),
+ * piece by piece: no buffer at all.
+ *
+ * @return size_t, the number of characters written
+ */
+inline size_t printReading(const Reading& reading, ReadingFormat format, Print& out) {
+  ReadingSink sink(out);
+  writeReading(reading, format, sink);
+  return sink.finish();
+}
+
+#endif
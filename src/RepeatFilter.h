@@ -0,0 +1,122 @@
+/**
+ * RepeatFilter.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file RepeatFilter.h
+ * @brief Drops repeated transmissions of the same reading.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: RepeatFilter added to OregonBridge library.
+ */
+
+#ifndef RepeatFilter_h
+#define RepeatFilter_h
+
+#include "Arduino.h"
+
+/* Number of sensors whose last packet is remembered (power of 2) */
+#ifndef OS_REPEAT_SLOTS
+#define OS_REPEAT_SLOTS 8
+#endif
+
+/**
+ * @brief Remembers the last packet of each sensor, to recognise repeats:
+ * v2.1 sensors send every message twice, and a packet can also be received
+ * again through a reflection or a second decoder.
+ *
+ * A fixed table, no heap: the sensor key (protocol, model, channel, id)
+ * selects one slot, which holds a hash of key and payload and the time the
+ * packet was first seen. A packet is a repeat if its slot holds the same
+ * hash, seen less than 'window' ago. Two sensors sharing a slot just evict
+ * each other: a repeat may then go through, a new reading is never dropped
+ * unless the 32 bit hashes collide.
+ */
+class RepeatFilter {
+ public:
+  RepeatFilter(uint32_t ms = 0) {
+    setWindow(ms);
+  }
+
+  /**
+   * @brief Sets the time within which an identical packet is a repeat.
+   *
+   * @param ms the window [ms], 0 to disable the filter
+   */
+  void setWindow(uint32_t ms) {
+    this->window = ms * 1000;
+  }
+
+  /* Forgets every packet seen */
+  void clear(void) {
+    memset(this->slots, 0, sizeof this->slots);
+  }
+
+  /**
+   * @brief Checks a valid packet and records it.
+   *
+   * @param key sensor key, see sensorKey()
+   * @param data the packet bytes
+   * @param length the number of bytes
+   * @param time receive time [us]
+   * @return true if the packet repeats one seen within the window
+   */
+  bool isRepeat(uint32_t key, const byte* data, byte length, uint32_t time) {
+    if (!this->window) return false;
+
+    uint32_t hash = key;
+    for (byte i = 0; i < length; i++) hash = (hash ^ data[i]) * 16777619UL;
+
+    Slot& slot = this->slots[key & (OS_REPEAT_SLOTS - 1)];
+    if (slot.used && slot.hash == hash && time - slot.time < this->window) return true;
+    slot.used = true;
+    slot.hash = hash;
+    slot.time = time;
+    return false;
+  }
+
+  /* FNV-1a hash of the sensor identity, first part of the packet hash */
+  static uint32_t sensorKey(byte protocol, word model, byte channel, byte id) {
+    const byte fields[5] = {protocol, (byte)(model >> 8), (byte)model, channel, id};
+    uint32_t hash = 2166136261UL;
+    for (byte i = 0; i < sizeof fields; i++) hash = (hash ^ fields[i]) * 16777619UL;
+    return hash;
+  }
+
+ private:
+  static_assert((OS_REPEAT_SLOTS & (OS_REPEAT_SLOTS - 1)) == 0, "OS_REPEAT_SLOTS must be a power of 2");
+
+  struct Slot {
+    uint32_t hash;
+    uint32_t time;
+    bool used;
+  };
+
+  Slot slots[OS_REPEAT_SLOTS] = {};
+  uint32_t window;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * SensorFilter.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file SensorFilter.h
+ * @brief Allowlist or denylist of sensors, checked while packets are received.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: SensorFilter added to OregonBridge library.
+ */
+
+#ifndef SensorFilter_h
+#define SensorFilter_h
+
+#include "Arduino.h"
+
+/* Number of (model, channel, id) entries a SensorFilter can hold */
+#ifndef OS_FILTER_SIZE
+#define OS_FILTER_SIZE 8
+#endif
+
+/**
+ * @brief Fixed-size list of sensors, keyed on (model, channel, id) as found in
+ * Reading. The decoders check it as soon as these header fields are received,
+ * and drop the packet on a miss: the decoder is free for the next preamble
+ * instead of decoding, validating and delivering a packet nobody wants.
+ *
+ * An empty filter accepts everything, whatever the mode.
+ */
+class SensorFilter {
+ public:
+  /* Wildcard for add(): any model, channel or id */
+  static const word ANY = 0xffff;
+
+  /* ALLOW: only the listed sensors pass. DENY: the listed sensors are dropped */
+  enum Mode { ALLOW,
+              DENY };
+
+  void setMode(Mode mode) {
+    this->mode = mode;
+  }
+
+  /**
+   * @brief Adds a sensor to the list.
+   *
+   * @param model model identifier (Reading::model, 0 for v1), or ANY
+   * @param channel channel (Reading::channel), or ANY
+   * @param id sensor id (Reading::id), or ANY
+   * @return false if the list is full (OS_FILTER_SIZE)
+   */
+  bool add(word model, word channel = ANY, word id = ANY) {
+    if (this->count >= OS_FILTER_SIZE) return false;
+    this->entries[this->count++] = {model, channel, id};
+    return true;
+  }
+
+  /* Removes every entry: everything passes again */
+  void clear(void) {
+    this->count = 0;
+  }
+
+  /* true if a packet with this header must be decoded */
+  bool accepts(word model, byte channel, byte id) const {
+    if (!this->count) return true;
+    bool listed = false;
+    for (byte i = 0; i < this->count && !listed; i++) {
+      const Entry& e = this->entries[i];
+      listed = (e.model == ANY || e.model == model) && (e.channel == ANY || e.channel == channel) &&
+               (e.id == ANY || e.id == id);
+    }
+    return listed == (this->mode == ALLOW);
+  }
+
+  /**
+   * @brief Decoder side: accepts() plus the count of packets dropped early.
+   */
+  bool check(word model, byte channel, byte id) {
+    if (accepts(model, channel, id)) return true;
+    this->rejected++;
+    return false;
+  }
+
+  /* Packets dropped by check() */
+  uint32_t rejected = 0;
+
+ private:
+  struct Entry {
+    word model, channel, id;
+  };
+
+  Entry entries[OS_FILTER_SIZE];
+  byte count = 0;
+  Mode mode = ALLOW;
+};
+
+#endif
@@ -0,0 +1,192 @@
+/**
+ * SensorRegistry.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file SensorRegistry.h
+ * @brief Stable sensor ids across battery changes (rolling ids).
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: SensorRegistry added to OregonBridge library.
+ */
+
+#ifndef SensorRegistry_h
+#define SensorRegistry_h
+
+#include "Arduino.h"
+#include "Reading.h"
+#include "RepeatFilter.h"
+
+/* Number of (model, channel) pairs tracked (power of 2), 0 disables re-identification */
+#ifndef OS_REID_SLOTS
+#define OS_REID_SLOTS 0
+#endif
+
+/* Least silence of the old id before a new one may take its place [ms] */
+#ifndef OS_REID_SILENCE_MS
+#define OS_REID_SILENCE_MS 300000
+#endif
+
+/* Largest temperature step from the old id to the new one [tenths of degree] */
+#ifndef OS_REID_MAX_DELTA
+#define OS_REID_MAX_DELTA 20
+#endif
+
+#if OS_REID_SLOTS > 0
+
+/**
+ * @brief Oregon sensors pick a new random id each time their batteries are
+ * changed. The registry remembers, for each (protocol, model, channel), the
+ * sensor heard there and its last values, and gives each reading a stable id
+ * (Reading::sensorId): the id first heard, kept when the sensor comes back
+ * with a new one.
+ *
+ * A new id takes over once the current id has been silent for
+ * OS_REID_SILENCE_MS, if its temperature and humidity (those the model
+ * measures) continue the old series. Models measuring neither (UV, wind,
+ * rain) are never re-identified. Until then, and for a second sensor sharing
+ * the model and channel, the stable id is the id itself.
+ *
+ * The silence may also be a live sensor missing a few transmissions, with a
+ * neighbour on the same model and channel taking its place. When the old id
+ * is heard again, it takes its stable id back and the neighbour gets its own
+ * id again: a stable id is never given to two sensors at once.
+ *
+ * Open-addressed fixed table, no heap: one hash and usually a single slot
+ * per packet. Once full, a new pair replaces the one heard least recently.
+ * Times are on the packet clock (Reading::time, micros()), which wraps every
+ * 71 minutes: a longer silence is still recognised, unless it ends within
+ * OS_REID_SILENCE_MS of a multiple of 71 minutes.
+ */
+class SensorRegistry {
+ public:
+  /**
+   * @brief Stable id of a reading, learning from it.
+   *
+   * @param reading a valid reading (not a repeat)
+   * @return byte, the stable id of its sensor
+   */
+  byte identify(const Reading& reading) {
+    Entry* e = this->lookup(reading.protocol, reading.model, reading.channel);
+    if (!e) {
+      e = this->insert(reading.protocol, reading.model, reading.channel);
+      e->sensorId = e->id = reading.id;
+    } else if (reading.id == e->sensorId) {
+      // the first sensor is back: the id which took over was a neighbour
+      e->id = reading.id;
+    } else if (e->id != reading.id) {
+      if (!this->takesOver(*e, reading)) return reading.id;
+      e->id = reading.id;
+      this->reidentified++;
+    }
+    e->lastSeen = reading.time;
+    e->temperature = reading.temperature;
+    e->humidity = reading.humidity;
+    return e->sensorId;
+  }
+
+  /* Stable id of a sensor id, without learning (e.g. for a failed packet) */
+  byte sensorIdOf(byte protocol, word model, byte channel, byte id) const {
+    const Entry* e = this->lookup(protocol, model, channel);
+    return e && e->id == id ? e->sensorId : id;
+  }
+
+  /* New ids mapped to a known sensor so far */
+  uint32_t reidentified = 0;
+
+ private:
+  static_assert((OS_REID_SLOTS & (OS_REID_SLOTS - 1)) == 0, "OS_REID_SLOTS must be a power of 2");
+
+  struct Entry {
+    uint32_t lastSeen;
+    int16_t temperature;
+    word model;
+    byte protocol, channel;
+    // stable id, and the id the sensor uses now
+    byte sensorId, id;
+    byte humidity;
+  };
+
+  Entry slots[OS_REID_SLOTS] = {};
+  byte count = 0;
+
+  /* true if 'reading', from a new id, continues the series of 'e', now silent.
+  The entry holds the same model, hence the same fields */
+  static bool takesOver(const Entry& e, const Reading& reading) {
+    if (reading.time - e.lastSeen < OS_REID_SILENCE_MS * 1000UL) return false;
+    // UV, wind and rain sensors: no series to compare, the new id stays apart
+    if (!reading.hasTemperature && !reading.hasHumidity) return false;
+    if (reading.hasTemperature) {
+      int16_t step = reading.temperature - e.temperature;
+      if (step > OS_REID_MAX_DELTA || step < -OS_REID_MAX_DELTA) return false;
+    }
+    if (reading.hasHumidity) {
+      int8_t hstep = reading.humidity - e.humidity;
+      if (hstep < -10 || hstep > 10) return false;
+    }
+    return true;
+  }
+
+  /* First slot probed for a (protocol, model, channel) pair */
+  static byte home(byte protocol, word model, byte channel) {
+    return RepeatFilter::sensorKey(protocol, model, channel, 0) & (OS_REID_SLOTS - 1);
+  }
+
+  /* Probes from the home slot to the pair, or to the first free slot */
+  Entry* lookup(byte protocol, word model, byte channel) const {
+    byte i = home(protocol, model, channel);
+    for (byte n = 0; n < OS_REID_SLOTS; n++, i = (i + 1) & (OS_REID_SLOTS - 1)) {
+      const Entry& e = this->slots[i];
+      if (!e.protocol) return nullptr;
+      if (e.protocol == protocol && e.model == model && e.channel == channel) return const_cast<Entry*>(&e);
+    }
+    return nullptr;
+  }
+
+  /* Slot for a new pair, replacing the least recently heard one if full (as SensorTable) */
+  Entry* insert(byte protocol, word model, byte channel) {
+    Entry* e;
+    if (this->count < OS_REID_SLOTS) {
+      byte i = home(protocol, model, channel);
+      while (this->slots[i].protocol) i = (i + 1) & (OS_REID_SLOTS - 1);
+      e = &this->slots[i];
+      this->count++;
+    } else {
+      e = this->slots;
+      for (byte i = 1; i < OS_REID_SLOTS; i++)
+        if ((int32_t)(this->slots[i].lastSeen - e->lastSeen) < 0) e = &this->slots[i];
+    }
+    memset(e, 0, sizeof *e);
+    e->protocol = protocol;
+    e->model = model;
+    e->channel = channel;
+    return e;
+  }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * SensorTable.h - This file is part of OregonBridge Arduino Library.
+ *
+ * @file SensorTable.h
+ * @brief Latest state of every sensor heard, kept by the bridge.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Revision history:
+ * - Oct. 2026: SensorTable added to OregonBridge library.
+ */
+
+#ifndef SensorTable_h
+#define SensorTable_h
+
+#include "Arduino.h"
+#include "Reading.h"
+#include "RepeatFilter.h"
+
+/* Number of sensors whose state is kept (power of 2), 0 disables the table */
+#ifndef OS_SENSOR_SLOTS
+#define OS_SENSOR_SLOTS 8
+#endif
+
+#if OS_SENSOR_SLOTS > 0
+
+/**
+ * @brief State of one sensor: its last reading and counters.
+ */
+struct SensorState {
+  /* Last valid reading. 'data' is not kept (nullptr), 'time' is its receive time [us] */
+  Reading reading;
+
+  /* Receive time of the last packet of the sensor, repeats included [us] */
+  uint32_t lastSeen;
+
+  /* Valid packets received, repeats included (wrapping) */
+  uint16_t packets;
+
+  /* Packets of the sensor failing the checksum (wrapping). Only counted once
+  the sensor is known, and when the failure spares the sensor fields */
+  uint16_t checksumErrors;
+};
+
+/**
+ * @brief Fixed table of the sensors heard, keyed by (protocol, model,
+ * channel, sensorId), open-addressed with linear probing: no heap, and a lookup
+ * usually reads a single slot. A sensor enters the table with its first
+ * valid reading; once the table is full, a new sensor takes the slot of the
+ * sensor heard least recently.
+ *
+ * Iterate with a range-based for loop:
+ *
+ *    for (const SensorState& s : orbridge.getSensors()) ...
+ */
+class SensorTable {
+ public:
+  /**
+   * @brief Get the state of one sensor.
+   *
+   * @param protocol OS_PROTOCOL_ID_V1, OS_PROTOCOL_ID_V2 or OS_PROTOCOL_ID_V3
+   * @param model model identifier (Reading::model, 0 for v1)
+   * @param channel channel (Reading::channel)
+   * @param id stable sensor id (Reading::sensorId)
+   * @return const SensorState*, the sensor state, nullptr if never heard
+   */
+  const SensorState* find(byte protocol, word model, byte channel, byte id) const {
+    return this->lookup(protocol, model, channel, id);
+  }
+
+  /* Number of sensors in the table */
+  byte getCount(void) const {
+    return this->count;
+  }
+
+  /* Sensors replaced by a new one because the table was full */
+  uint16_t getEvictions(void) const {
+    return this->evictions;
+  }
+
+  /* Forgets every sensor */
+  void clear(void) {
+    memset(this->slots, 0, sizeof this->slots);
+    this->count = 0;
+    this->evictions = 0;
+  }
+
+  /* Walks the used slots, see begin() and end() */
+  class Iterator {
+   public:
+    Iterator(const SensorState* slot, const SensorState* end) : slot(slot), end(end) { skip(); }
+
+    const SensorState& operator*() const { return *this->slot; }
+    const SensorState* operator->() const { return this->slot; }
+
+    Iterator& operator++() {
+      ++this->slot;
+      skip();
+      return *this;
+    }
+
+    bool operator!=(const Iterator& other) const { return this->slot != other.slot; }
+
+   private:
+    const SensorState* slot;
+    const SensorState* end;
+
+    // free slots have protocol 0
+    void skip() {
+      while (this->slot != this->end && !this->slot->reading.protocol) ++this->slot;
+    }
+  };
+
+  Iterator begin(void) const {
+    return Iterator(this->slots, this->slots + OS_SENSOR_SLOTS);
+  }
+
+  Iterator end(void) const {
+    return Iterator(this->slots + OS_SENSOR_SLOTS, this->slots + OS_SENSOR_SLOTS);
+  }
+
+  /* A reading was delivered: stores it ('data' excepted), adding the sensor if new */
+  void store(const Reading& reading) {
+    SensorState* s = this->lookup(reading.protocol, reading.model, reading.channel, reading.sensorId);
+    if (!s) s = this->insert(reading.protocol, reading.model, reading.channel, reading.sensorId);
+    s->reading = reading;
+    s->reading.data = nullptr;
+    s->lastSeen = reading.time;
+    s->packets++;
+  }
+
+  /* A repeat of a delivered reading was received */
+  void repeated(byte protocol, word model, byte channel, byte id, uint32_t time) {
+    SensorState* s = this->lookup(protocol, model, channel, id);
+    if (!s) return;
+    s->lastSeen = time;
+    s->packets++;
+  }
+
+  /* A packet failed the checksum: counted if its fields match a known sensor */
+  void failed(byte protocol, word model, byte channel, byte id) {
+    SensorState* s = this->lookup(protocol, model, channel, id);
+    if (s) s->checksumErrors++;
+  }
+
+ private:
+  static_assert((OS_SENSOR_SLOTS & (OS_SENSOR_SLOTS - 1)) == 0, "OS_SENSOR_SLOTS must be a power of 2");
+
+  SensorState slots[OS_SENSOR_SLOTS] = {};
+  byte count = 0;
+  uint16_t evictions = 0;
+
+  /* First slot probed for a sensor */
+  static byte home(byte protocol, word model, byte channel, byte id) {
+    return RepeatFilter::sensorKey(protocol, model, channel, id) & (OS_SENSOR_SLOTS - 1);
+  }
+
+  /* Probes from the home slot to the sensor, or to the first free slot */
+  SensorState* lookup(byte protocol, word model, byte channel, byte id) const {
+    byte i = home(protocol, model, channel, id);
+    for (byte n = 0; n < OS_SENSOR_SLOTS; n++, i = (i + 1) & (OS_SENSOR_SLOTS - 1)) {
+      const Reading& r = this->slots[i].reading;
+      if (!r.protocol) return nullptr;
+      if (r.protocol == protocol && r.model == model && r.channel == channel && r.sensorId == id)
+        return const_cast<SensorState*>(&this->slots[i]);
+    }
+    return nullptr;
+  }
+
+  /* Slot for a new sensor: the first free one after its home slot. Once the
+  table is full no slot is ever freed again, so replacing the oldest sensor in
+  place keeps every probe sequence intact */
+  SensorState* insert(byte protocol, word model, byte channel, byte id) {
+    SensorState* s;
+    if (this->count < OS_SENSOR_SLOTS) {
+      byte i = home(protocol, model, channel, id);
+      while (this->slots[i].reading.protocol) i = (i + 1) & (OS_SENSOR_SLOTS - 1);
+      s = &this->slots[i];
+      this->count++;
+    } else {
+      s = this->slots;
+      for (byte i = 1; i < OS_SENSOR_SLOTS; i++)
+        if ((int32_t)(this->slots[i].lastSeen - s->lastSeen) < 0) s = &this->slots[i];
+      this->evictions++;
+    }
+    memset(s, 0, sizeof *s);
+    return s;
+  }
+};
+
+#endif
+
+#endif
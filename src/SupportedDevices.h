@@ -1,15 +1,10 @@
 #ifndef _DEVICES_H
 #define _DEVICES_H
 
-#define DEVICES_NUM 2
-
+/* Every supported device. New devices must also be listed in the default
+OregonBridge alias, in OregonBridge.h */
 #include "OregonDevice_v1.h"
 #include "OregonDevice_v2.h"
+#include "OregonDevice_v3.h"
 
-#define INCL_DEV(devClass) addDevice<devClass>();
-
-#define INCLUDE_ALL_DEVICES \
-    INCL_DEV(OregonDevice_v1) \
-    INCL_DEV(OregonDevice_v2) \
-    
-#endif
\ No newline at end of file
+#endif